@@ -0,0 +1,195 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+/*
+Standalone check and benchmark of the batch kernels of TransformationActorsMath.h, without the engine.
+Build and run on Linux:
+	g++ -O2 -std=c++14 -I ../../Source/TransformationActorsPlugin/Public TransformationActorsMathBenchmark.cpp -o MathBenchmark && ./MathBenchmark
+Add -DTRANSFORMATIONACTORS_MATH_FORCE_SCALAR to measure the scalar fallback.
+*/
+
+#include "TransformationActorsMath.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace TransformationActorsMath;
+
+	/*Transform in the layout of the engine, used by the reference implementation.*/
+	struct FReferenceTransform
+	{
+		float Location[3];
+		float Rotation[4];
+		float Scale[3];
+	};
+
+	void ReferenceRotateAroundPivot(FReferenceTransform& Transform, const float Delta[4], const float Pivot[3])
+	{
+		/*v' = v + 2w(q x v) + 2q x (q x v), the same formula as FQuat::RotateVector.*/
+		const float V[3] = { Transform.Location[0] - Pivot[0], Transform.Location[1] - Pivot[1], Transform.Location[2] - Pivot[2] };
+		const float T[3] = {
+			2.f * (Delta[1] * V[2] - Delta[2] * V[1]),
+			2.f * (Delta[2] * V[0] - Delta[0] * V[2]),
+			2.f * (Delta[0] * V[1] - Delta[1] * V[0]) };
+
+		Transform.Location[0] = Pivot[0] + V[0] + Delta[3] * T[0] + (Delta[1] * T[2] - Delta[2] * T[1]);
+		Transform.Location[1] = Pivot[1] + V[1] + Delta[3] * T[1] + (Delta[2] * T[0] - Delta[0] * T[2]);
+		Transform.Location[2] = Pivot[2] + V[2] + Delta[3] * T[2] + (Delta[0] * T[1] - Delta[1] * T[0]);
+
+		const float* B = Transform.Rotation;
+		const float R[4] = {
+			Delta[3] * B[0] + Delta[0] * B[3] + Delta[1] * B[2] - Delta[2] * B[1],
+			Delta[3] * B[1] - Delta[0] * B[2] + Delta[1] * B[3] + Delta[2] * B[0],
+			Delta[3] * B[2] + Delta[0] * B[1] - Delta[1] * B[0] + Delta[2] * B[3],
+			Delta[3] * B[3] - Delta[0] * B[0] - Delta[1] * B[1] - Delta[2] * B[2] };
+
+		for (int Index = 0; Index < 4; ++Index)
+		{
+			Transform.Rotation[Index] = R[Index];
+		}
+	}
+
+	void MakeUnitQuat(std::mt19937& Random, float OutQuat[4])
+	{
+		std::uniform_real_distribution<float> Distribution(-1.f, 1.f);
+		float Length = 0.f;
+		for (int Index = 0; Index < 4; ++Index)
+		{
+			OutQuat[Index] = Distribution(Random);
+			Length += OutQuat[Index] * OutQuat[Index];
+		}
+		Length = std::sqrt(Length);
+		for (int Index = 0; Index < 4; ++Index)
+		{
+			OutQuat[Index] /= Length;
+		}
+	}
+
+	template <typename FunctionType>
+	double MeasureNanosecondsPerItem(int32_t Num, int32_t Repeats, FunctionType Function)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		for (int32_t Repeat = 0; Repeat < Repeats; ++Repeat)
+		{
+			Function();
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(End - Start).count() / (static_cast<double>(Num) * Repeats);
+	}
+
+	/*Compare the kernels with the reference on Num random transforms and print the timings. Return false on a mismatch.*/
+	bool Run(int32_t Num)
+	{
+		std::mt19937 Random(Num);
+		std::uniform_real_distribution<float> Distribution(-1000.f, 1000.f);
+		std::uniform_real_distribution<float> ScaleDistribution(0.1f, 4.f);
+
+		std::vector<FReferenceTransform> Reference(Num);
+		std::vector<float> Buffer(FTransformStreams::GetBufferSize(Num));
+		std::vector<uint8_t> IsValid(Num);
+		FTransformStreams Streams;
+		Streams.Bind(Buffer.data(), Num);
+
+		for (int32_t Index = 0; Index < Num; ++Index)
+		{
+			FReferenceTransform& Transform = Reference[Index];
+			for (int Axis = 0; Axis < 3; ++Axis)
+			{
+				Transform.Location[Axis] = Distribution(Random);
+				Transform.Scale[Axis] = ScaleDistribution(Random);
+			}
+			MakeUnitQuat(Random, Transform.Rotation);
+
+			Streams.Locations.X[Index] = Transform.Location[0];
+			Streams.Locations.Y[Index] = Transform.Location[1];
+			Streams.Locations.Z[Index] = Transform.Location[2];
+			Streams.Rotations.X[Index] = Transform.Rotation[0];
+			Streams.Rotations.Y[Index] = Transform.Rotation[1];
+			Streams.Rotations.Z[Index] = Transform.Rotation[2];
+			Streams.Rotations.W[Index] = Transform.Rotation[3];
+			Streams.Scales.X[Index] = Transform.Scale[0];
+			Streams.Scales.Y[Index] = Transform.Scale[1];
+			Streams.Scales.Z[Index] = Transform.Scale[2];
+		}
+
+		float Delta[4];
+		MakeUnitQuat(Random, Delta);
+		const float Pivot[3] = { 10.f, -20.f, 30.f };
+		const float Translation[3] = { 1.f, 2.f, 3.f };
+		const float Ratio[3] = { 0.5f, 1.5f, 0.25f };
+		const float MinScale = 0.1f;
+
+		/*Correctness of one application of each kernel.*/
+		TranslateLocations(Streams.Locations, Num, Translation);
+		RotateAroundPivot(Streams.Locations, Streams.Rotations, Num, Delta, Pivot);
+		MultiplyScalesClamped(Streams.Scales, Streams.Scales, Num, Ratio, MinScale, IsValid.data());
+
+		float MaxLocationError = 0.f;
+		float MaxRotationError = 0.f;
+		bool bIsValidMatching = true;
+		for (int32_t Index = 0; Index < Num; ++Index)
+		{
+			FReferenceTransform& Transform = Reference[Index];
+			for (int Axis = 0; Axis < 3; ++Axis)
+			{
+				Transform.Location[Axis] += Translation[Axis];
+				Transform.Scale[Axis] *= Ratio[Axis];
+			}
+			ReferenceRotateAroundPivot(Transform, Delta, Pivot);
+
+			const float Locations[3] = { Streams.Locations.X[Index], Streams.Locations.Y[Index], Streams.Locations.Z[Index] };
+			const float Rotations[4] = { Streams.Rotations.X[Index], Streams.Rotations.Y[Index], Streams.Rotations.Z[Index], Streams.Rotations.W[Index] };
+			for (int Axis = 0; Axis < 3; ++Axis)
+			{
+				MaxLocationError = std::fmax(MaxLocationError, std::fabs(Locations[Axis] - Transform.Location[Axis]));
+			}
+			for (int Axis = 0; Axis < 4; ++Axis)
+			{
+				MaxRotationError = std::fmax(MaxRotationError, std::fabs(Rotations[Axis] - Transform.Rotation[Axis]));
+			}
+
+			const bool bIsReferenceValid = Transform.Scale[0] > MinScale && Transform.Scale[1] > MinScale && Transform.Scale[2] > MinScale;
+			bIsValidMatching = bIsValidMatching && (IsValid[Index] != 0) == bIsReferenceValid;
+		}
+
+		/*Enough work per measurement for the small batches too.*/
+		const int32_t Repeats = Num < 100000 ? 2000000 / Num + 1 : 20;
+		const float NoTranslation[3] = { 0.f, 0.f, 0.f };
+		const float UnitRatio[3] = { 1.f, 1.f, 1.f };
+
+		const double TranslateTime = MeasureNanosecondsPerItem(Num, Repeats, [&]() { TranslateLocations(Streams.Locations, Num, NoTranslation); });
+		const double RotateTime = MeasureNanosecondsPerItem(Num, Repeats, [&]() { RotateAroundPivot(Streams.Locations, Streams.Rotations, Num, Delta, Pivot); });
+		const double ScaleTime = MeasureNanosecondsPerItem(Num, Repeats, [&]() { MultiplyScalesClamped(Streams.Scales, Streams.Scales, Num, UnitRatio, MinScale, IsValid.data()); });
+		const double ReferenceRotateTime = MeasureNanosecondsPerItem(Num, Repeats, [&]()
+		{
+			for (FReferenceTransform& Transform : Reference)
+			{
+				ReferenceRotateAroundPivot(Transform, Delta, Pivot);
+			}
+		});
+
+		const bool bIsPassed = MaxLocationError < 0.05f && MaxRotationError < 1e-5f && bIsValidMatching;
+		std::printf("%8d  translate %6.2f  rotate %6.2f (reference %6.2f)  scale %6.2f ns/transform  errors %g %g  %s\n",
+			Num, TranslateTime, RotateTime, ReferenceRotateTime, ScaleTime, MaxLocationError, MaxRotationError, bIsPassed ? "ok" : "MISMATCH");
+
+		return bIsPassed;
+	}
+}
+
+int main()
+{
+	std::printf("TransformationActorsMath: %s\n", TRANSFORMATIONACTORS_MATH_SSE ? "SSE" : TRANSFORMATIONACTORS_MATH_NEON ? "NEON" : "scalar");
+
+	bool bIsPassed = true;
+	for (int32_t Num : { 1, 3, 16, 257, 4096, 65536, 1000000 })
+	{
+		bIsPassed = Run(Num) && bIsPassed;
+	}
+
+	return bIsPassed ? 0 : 1;
+}
@@ -0,0 +1,569 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsBenchmark.h"
+#include "TransformationActorsComponent.h"
+#include "TransformationActorsStats.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/DefaultPawn.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+ATransformationActorsBenchmarkActor::ATransformationActorsBenchmarkActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Box = CreateDefaultSubobject<UBoxComponent>(TEXT("Box"));
+	Box->SetBoxExtent(FVector(50.f));
+	Box->SetMobility(EComponentMobility::Movable);
+	Box->SetCollisionProfileName(TEXT("BlockAllDynamic"));
+	RootComponent = Box;
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace TransformationActorsBenchmark
+{
+	const TCHAR* CsvHeader = TEXT("Path,NumActors,NumUpdates,MeanUs,MedianUs,P95Us,MaxUs,Skipped,AllocationsPerUpdate,QueriesPerUpdate");
+
+	/*Distance between the spawned actors.*/
+	const float GridSpacing = 200.f;
+
+	/*Radius of the synthetic cursor motion in pixels and the screen it moves on.*/
+	const float MouseRadius = 100.f;
+	const FVector2D ScreenCenter(960.f, 540.f);
+
+	/*Height of the synthetic camera above the grid, in the grid sizes, and the radius of the cursor motion on the grid, in the grid spacings.*/
+	const float CameraHeight = 1.5f;
+	const float WorldRadius = 2.f;
+
+	/*
+	Proxy of GMalloc that counts the allocations while the benchmark measures.
+	The allocations of all threads are counted, so the count of an update is an upper bound of its own allocations.
+	*/
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+
+		explicit FCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			NumAllocations.Increment();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				NumAllocations.Increment();
+			}
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+
+		/*Replace GMalloc by the proxy. The blocks are allocated by the inner allocator, so they can be freed after End().*/
+		void Begin()
+		{
+			InnerMalloc = GMalloc;
+			GMalloc = this;
+		}
+
+		void End()
+		{
+			GMalloc = InnerMalloc;
+		}
+
+		int32 GetNumAllocations() const { return NumAllocations.GetValue(); }
+
+	private:
+
+		FMalloc* InnerMalloc;
+		FThreadSafeCounter NumAllocations;
+	};
+
+	/*The proxy lives until the exit: the other threads may still call it right after End().*/
+	FCountingMalloc& GetCountingMalloc()
+	{
+		static FCountingMalloc CountingMalloc(GMalloc);
+		return CountingMalloc;
+	}
+
+	/*Quit with the result of the benchmark as the exit code, so the scripts can check it.*/
+	void RequestExitWithResult(bool bIsPassed)
+	{
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25
+		FPlatformMisc::RequestExitWithStatus(false, bIsPassed ? 0 : 1);
+#else
+		/*Before 4.25 only the forced exit after a critical error returns a non-zero code.*/
+		if (!bIsPassed)
+		{
+			GIsCriticalError = true;
+			GLog->Flush();
+			FPlatformMisc::RequestExit(true);
+		}
+		FPlatformMisc::RequestExit(false);
+#endif
+	}
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchmarkCommand(
+		TEXT("TransformationActors.Benchmark"),
+		TEXT("Measure the transformation hot paths. Params: Actors=1,10,100,1000,10000 Updates=200 Csv=File.csv Baseline=File.csv Tolerance=0.2 Quit"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+		{
+			const FString Params = FString::Join(Args, TEXT(" "));
+			const bool bIsPassed = FTransformationActorsBenchmark::Run(World, Params, Ar);
+
+			if (FParse::Param(*Params, TEXT("Quit")))
+			{
+				RequestExitWithResult(bIsPassed);
+			}
+		}));
+}
+
+bool FTransformationActorsBenchmark::Run(UWorld* World, const FString& Params, FOutputDevice& Ar)
+{
+	using namespace TransformationActorsBenchmark;
+
+	if (World == nullptr || !World->IsGameWorld())
+	{
+		Ar.Logf(ELogVerbosity::Error, TEXT("TransformationActors: Benchmark: the game world is not valid."));
+		return false;
+	}
+
+	FString ActorsParam = TEXT("1,10,100,1000,10000");
+	FParse::Value(*Params, TEXT("Actors="), ActorsParam, false);
+
+	int32 NumUpdates = 200;
+	FParse::Value(*Params, TEXT("Updates="), NumUpdates);
+	NumUpdates = FMath::Max(NumUpdates, 1);
+
+	FString CsvFileName = FPaths::Combine(FPaths::ProfilingDir(), TEXT("TransformationActors"), TEXT("Benchmark.csv"));
+	FParse::Value(*Params, TEXT("Csv="), CsvFileName);
+
+	FString BaselineFileName;
+	FParse::Value(*Params, TEXT("Baseline="), BaselineFileName);
+
+	float Tolerance = 0.2f;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	TArray<FString> ActorCounts;
+	ActorsParam.ParseIntoArray(ActorCounts, TEXT(","));
+
+	TArray<FResult> Results;
+	for (const FString& ActorCount : ActorCounts)
+	{
+		const int32 NumActors = FCString::Atoi(*ActorCount);
+		if (NumActors > 0)
+		{
+			RunForActors(World, NumActors, NumUpdates, Results);
+		}
+	}
+
+	for (const FResult& Result : Results)
+	{
+		if (Result.bIsSkipped)
+		{
+			Ar.Logf(TEXT("TransformationActors: Benchmark: %s, %d actors: skipped."), *Result.Path, Result.NumActors);
+		}
+		else
+		{
+			Ar.Logf(TEXT("TransformationActors: Benchmark: %s, %d actors: mean %.2f us, median %.2f us, p95 %.2f us, max %.2f us, %.2f allocations, %.2f scene queries."),
+				*Result.Path, Result.NumActors, Result.MeanUs, Result.MedianUs, Result.P95Us, Result.MaxUs, Result.AllocationsPerUpdate, Result.QueriesPerUpdate);
+		}
+	}
+
+	if (!WriteCsv(CsvFileName, Results))
+	{
+		Ar.Logf(ELogVerbosity::Error, TEXT("TransformationActors: Benchmark: %s can't be written."), *CsvFileName);
+		return false;
+	}
+	Ar.Logf(TEXT("TransformationActors: Benchmark: results are written to %s."), *CsvFileName);
+
+	if (BaselineFileName.IsEmpty())
+	{
+		return true;
+	}
+
+	TArray<FResult> Baseline;
+	if (!ReadCsv(BaselineFileName, Baseline))
+	{
+		Ar.Logf(ELogVerbosity::Error, TEXT("TransformationActors: Benchmark: baseline %s can't be read."), *BaselineFileName);
+		return false;
+	}
+
+	const int32 NumRegressions = CompareWithBaseline(Results, Baseline, Tolerance, Ar);
+	if (NumRegressions > 0)
+	{
+		Ar.Logf(ELogVerbosity::Error, TEXT("TransformationActors: Benchmark: FAILED, %d regressions against %s."), NumRegressions, *BaselineFileName);
+		return false;
+	}
+
+	Ar.Logf(TEXT("TransformationActors: Benchmark: PASSED against %s."), *BaselineFileName);
+	return true;
+}
+
+void FTransformationActorsBenchmark::RunForActors(UWorld* World, int32 NumActors, int32 NumUpdates, TArray<FResult>& OutResults)
+{
+	using namespace TransformationActorsBenchmark;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	/*The host of the component is not selected, its root gives the axes of the keyboard paths.*/
+	ATransformationActorsBenchmarkActor* Host = World->SpawnActor<ATransformationActorsBenchmarkActor>(FVector(0.f, 0.f, -GridSpacing), FRotator::ZeroRotator, SpawnParameters);
+	if (Host == nullptr)
+	{
+		return;
+	}
+
+	TArray<AActor*> Actors;
+	Actors.Reserve(NumActors);
+
+	const int32 GridSide = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumActors)));
+	for (int32 Index = 0; Index < NumActors; ++Index)
+	{
+		const FVector Location((Index % GridSide) * GridSpacing, (Index / GridSide) * GridSpacing, 0.f);
+		if (AActor* Actor = World->SpawnActor<ATransformationActorsBenchmarkActor>(Location, FRotator::ZeroRotator, SpawnParameters))
+		{
+			Actors.Add(Actor);
+		}
+	}
+
+	UTransformationActorsComponent* Component = NewObject<UTransformationActorsComponent>(Host, TEXT("BenchmarkComponent"), RF_Transient);
+	Component->RegisterComponent();
+	Component->SetComponentForTransformationAxis(Host->GetRootComponent());
+	Component->SetIsHistoryEnabled(false);
+
+	if (Actors.Num() > 0)
+	{
+		Component->SetTransformActor(Actors[0]);
+		for (AActor* Actor : Actors)
+		{
+			Component->AddActorToSelection(Actor);
+		}
+	}
+
+	/*
+	The mouse paths are driven by the virtual cursor and the cursor ray, so they don't need a viewport and run with -nullrhi too.
+	The controller and the pawn are spawned if the world has none, e.g. on a dedicated server.
+	*/
+	APlayerController* PlayerController = World->GetFirstPlayerController();
+	APlayerController* SpawnedController = nullptr;
+	if (PlayerController == nullptr)
+	{
+		SpawnedController = World->SpawnActor<APlayerController>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParameters);
+		PlayerController = SpawnedController;
+	}
+
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	APawn* SpawnedPawn = nullptr;
+	if (PlayerPawn == nullptr)
+	{
+		SpawnedPawn = World->SpawnActor<ADefaultPawn>(FVector(0.f, 0.f, GridSpacing), FRotator::ZeroRotator, SpawnParameters);
+		PlayerPawn = SpawnedPawn;
+	}
+
+	Component->SetPlayerController(PlayerController);
+	Component->SetPlayerPawn(PlayerPawn);
+
+	/*The synthetic motion is a circle around the center of the screen and around the center of the grid under the camera.*/
+	const FVector GridCenter((GridSide - 1) * GridSpacing * 0.5f, (GridSide - 1) * GridSpacing * 0.5f, 0.f);
+	const FVector CameraLocation = GridCenter + FVector(0.f, 0.f, FMath::Max(GridSide * GridSpacing * CameraHeight, GridSpacing));
+
+	auto MoveMouse = [Component, PlayerController, GridCenter, CameraLocation](int32 Update) -> bool
+	{
+		if (PlayerController == nullptr)
+		{
+			return false;
+		}
+
+		const float Angle = Update * 0.1f;
+		const FVector2D Direction(FMath::Cos(Angle), FMath::Sin(Angle));
+		const FVector CursorTarget = GridCenter + FVector(Direction * GridSpacing * WorldRadius, 0.f);
+
+		return Component->SetPlayerCursorPosition(PlayerController, ScreenCenter + Direction * MouseRadius)
+			&& Component->SetPlayerCursorRay(PlayerController, CameraLocation, CursorTarget - CameraLocation);
+	};
+
+	Component->SetTransformState(ETransformState::ETS_Location);
+	Component->SetIsLockFirstIterationLocationTimer(false);
+	OutResults.Add(Measure(TEXT("LocationActor"), NumActors, NumUpdates, [Component, &MoveMouse](int32 Update)
+	{
+		if (!MoveMouse(Update))
+		{
+			return false;
+		}
+		Component->LocationActor();
+		return true;
+	}));
+
+	Component->SetTransformState(ETransformState::ETS_Rotation_YawPitch);
+	Component->SetIsLockFirstIterationRotationTimer(false);
+	OutResults.Add(Measure(TEXT("RotationActor"), NumActors, NumUpdates, [Component, &MoveMouse](int32 Update)
+	{
+		if (!MoveMouse(Update) || Component->GetPlayerPawn() == nullptr)
+		{
+			return false;
+		}
+		Component->RotationActor();
+		return true;
+	}));
+
+	Component->SetTransformState(ETransformState::ETS_Scale);
+	Component->SetIsLockFirstIterationScaleTimer(false);
+	OutResults.Add(Measure(TEXT("ScaleActor"), NumActors, NumUpdates, [Component, &MoveMouse](int32 Update)
+	{
+		if (!MoveMouse(Update))
+		{
+			return false;
+		}
+		Component->ScaleActor();
+		return true;
+	}));
+
+	Component->SetTransformState(ETransformState::ETS_Idle);
+
+	/*The keyboard paths alternate the direction, so the actors stay in place.*/
+	OutResults.Add(Measure(TEXT("LocationKeyboardBasic"), NumActors, NumUpdates, [Component](int32 Update)
+	{
+		Component->LocationKeyboardBasic(FVector((Update & 1) ? -10.f : 10.f, 0.f, 0.f));
+		return true;
+	}));
+
+	OutResults.Add(Measure(TEXT("RotationKeyboardBasic"), NumActors, NumUpdates, [Component](int32 Update)
+	{
+		Component->RotationKeyboardBasic((Update & 1) ? -1.f : 1.f, FVector::UpVector);
+		return true;
+	}));
+
+	OutResults.Add(Measure(TEXT("ScaleKeyboardBasic"), NumActors, NumUpdates, [Component](int32 Update)
+	{
+		Component->ScaleKeyboardBasic(FVector((Update & 1) ? -0.1f : 0.1f));
+		return true;
+	}));
+
+	Component->ReleasePlayerCursor(PlayerController);
+	Component->ClearSelection();
+	Component->DestroyComponent();
+
+	for (AActor* Actor : Actors)
+	{
+		Actor->Destroy();
+	}
+	Host->Destroy();
+
+	if (SpawnedPawn)
+	{
+		SpawnedPawn->Destroy();
+	}
+	if (SpawnedController)
+	{
+		SpawnedController->Destroy();
+	}
+}
+
+FTransformationActorsBenchmark::FResult FTransformationActorsBenchmark::Measure(const FString& Path, int32 NumActors, int32 NumUpdates, TFunctionRef<bool(int32)> Update)
+{
+	FResult Result;
+	Result.Path = Path;
+	Result.NumActors = NumActors;
+	Result.NumUpdates = 0;
+	Result.MeanUs = 0.0;
+	Result.MedianUs = 0.0;
+	Result.P95Us = 0.0;
+	Result.MaxUs = 0.0;
+	Result.bIsSkipped = false;
+	Result.AllocationsPerUpdate = 0.0;
+	Result.QueriesPerUpdate = 0.0;
+
+	TArray<double> Times;
+	Times.Reserve(NumUpdates);
+
+	TransformationActorsBenchmark::FCountingMalloc& CountingMalloc = TransformationActorsBenchmark::GetCountingMalloc();
+	int64 NumAllocations = 0;
+	int64 NumQueries = 0;
+
+	for (int32 Index = 0; Index < NumUpdates; ++Index)
+	{
+		const int32 StartAllocations = CountingMalloc.GetNumAllocations();
+		const int32 StartQueries = GTransformationActorsSceneQueries.GetValue();
+
+		CountingMalloc.Begin();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const bool bIsUpdated = Update(Index);
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		CountingMalloc.End();
+
+		if (!bIsUpdated)
+		{
+			Result.bIsSkipped = Times.Num() == 0;
+			break;
+		}
+		Times.Add(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000.0);
+		NumAllocations += CountingMalloc.GetNumAllocations() - StartAllocations;
+		NumQueries += GTransformationActorsSceneQueries.GetValue() - StartQueries;
+	}
+
+	if (Times.Num() == 0)
+	{
+		Result.bIsSkipped = true;
+		return Result;
+	}
+
+	Times.Sort();
+
+	double Sum = 0.0;
+	for (double Time : Times)
+	{
+		Sum += Time;
+	}
+
+	Result.NumUpdates = Times.Num();
+	Result.MeanUs = Sum / Times.Num();
+	Result.MedianUs = Times[Times.Num() / 2];
+	Result.P95Us = Times[FMath::Min(Times.Num() - 1, (Times.Num() * 95) / 100)];
+	Result.MaxUs = Times.Last();
+	Result.AllocationsPerUpdate = static_cast<double>(NumAllocations) / Times.Num();
+	Result.QueriesPerUpdate = static_cast<double>(NumQueries) / Times.Num();
+
+	return Result;
+}
+
+bool FTransformationActorsBenchmark::WriteCsv(const FString& FileName, const TArray<FResult>& Results)
+{
+	TArray<FString> Lines;
+	Lines.Add(TransformationActorsBenchmark::CsvHeader);
+
+	for (const FResult& Result : Results)
+	{
+		Lines.Add(FString::Printf(TEXT("%s,%d,%d,%.3f,%.3f,%.3f,%.3f,%d,%.3f,%.3f"),
+			*Result.Path, Result.NumActors, Result.NumUpdates, Result.MeanUs, Result.MedianUs, Result.P95Us, Result.MaxUs, Result.bIsSkipped ? 1 : 0,
+			Result.AllocationsPerUpdate, Result.QueriesPerUpdate));
+	}
+
+	return FFileHelper::SaveStringArrayToFile(Lines, *FileName);
+}
+
+bool FTransformationActorsBenchmark::ReadCsv(const FString& FileName, TArray<FResult>& OutResults)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FileName))
+	{
+		return false;
+	}
+
+	OutResults.Reset();
+
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		TArray<FString> Columns;
+		if (Lines[LineIndex].ParseIntoArray(Columns, TEXT(","), false) < 8)
+		{
+			continue;
+		}
+
+		FResult Result;
+		Result.Path = Columns[0];
+		Result.NumActors = FCString::Atoi(*Columns[1]);
+		Result.NumUpdates = FCString::Atoi(*Columns[2]);
+		Result.MeanUs = FCString::Atod(*Columns[3]);
+		Result.MedianUs = FCString::Atod(*Columns[4]);
+		Result.P95Us = FCString::Atod(*Columns[5]);
+		Result.MaxUs = FCString::Atod(*Columns[6]);
+		Result.bIsSkipped = FCString::Atoi(*Columns[7]) != 0;
+		/*The baselines written before the counts were recorded have no counts, they are not compared.*/
+		Result.AllocationsPerUpdate = Columns.Num() > 8 ? FCString::Atod(*Columns[8]) : -1.0;
+		Result.QueriesPerUpdate = Columns.Num() > 9 ? FCString::Atod(*Columns[9]) : -1.0;
+		OutResults.Add(Result);
+	}
+
+	return true;
+}
+
+int32 FTransformationActorsBenchmark::CompareWithBaseline(const TArray<FResult>& Results, const TArray<FResult>& Baseline, float Tolerance, FOutputDevice& Ar)
+{
+	int32 NumRegressions = 0;
+
+	for (const FResult& Result : Results)
+	{
+		if (Result.bIsSkipped)
+		{
+			continue;
+		}
+
+		const FResult* BaselineResult = Baseline.FindByPredicate([&Result](const FResult& Other)
+		{
+			return !Other.bIsSkipped && Other.NumActors == Result.NumActors && Other.Path == Result.Path;
+		});
+
+		if (BaselineResult == nullptr)
+		{
+			continue;
+		}
+
+		/*The median is compared, it is stable against the single spikes.*/
+		if (Result.MedianUs > BaselineResult->MedianUs * (1.f + Tolerance))
+		{
+			Ar.Logf(ELogVerbosity::Error, TEXT("TransformationActors: Benchmark: regression in %s, %d actors: median %.2f us, baseline %.2f us."),
+				*Result.Path, Result.NumActors, Result.MedianUs, BaselineResult->MedianUs);
+			++NumRegressions;
+		}
+
+		/*The counts of the other threads add up to one allocation of noise per update.*/
+		if (BaselineResult->AllocationsPerUpdate >= 0.0 && Result.AllocationsPerUpdate > BaselineResult->AllocationsPerUpdate * (1.f + Tolerance) + 1.0)
+		{
+			Ar.Logf(ELogVerbosity::Error, TEXT("TransformationActors: Benchmark: regression in %s, %d actors: %.2f allocations, baseline %.2f."),
+				*Result.Path, Result.NumActors, Result.AllocationsPerUpdate, BaselineResult->AllocationsPerUpdate);
+			++NumRegressions;
+		}
+
+		if (BaselineResult->QueriesPerUpdate >= 0.0 && Result.QueriesPerUpdate > BaselineResult->QueriesPerUpdate * (1.f + Tolerance))
+		{
+			Ar.Logf(ELogVerbosity::Error, TEXT("TransformationActors: Benchmark: regression in %s, %d actors: %.2f scene queries, baseline %.2f."),
+				*Result.Path, Result.NumActors, Result.QueriesPerUpdate, BaselineResult->QueriesPerUpdate);
+			++NumRegressions;
+		}
+	}
+
+	return NumRegressions;
+}
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,78 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TransformationActorsInterface.h"
+#include "TransformationActorsBenchmark.generated.h"
+
+class UBoxComponent;
+class UTransformationActorsComponent;
+class FOutputDevice;
+
+/*Actor with a box collision that implements TransformationActorsInterface. Spawned by the benchmark.*/
+UCLASS(NotPlaceable, Transient, NotBlueprintable)
+class ATransformationActorsBenchmarkActor : public AActor, public ITransformationActorsInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	ATransformationActorsBenchmarkActor();
+
+	UPROPERTY()
+		UBoxComponent* Box;
+};
+
+#if !UE_BUILD_SHIPPING
+
+/*
+Benchmark of the transformation hot paths. Runs in the current game world, also with -nullrhi.
+Console command:
+	TransformationActors.Benchmark [Actors=1,10,100,1000,10000] [Updates=200] [Csv=File.csv] [Baseline=File.csv] [Tolerance=0.2] [Quit]
+For each number of actors the actors are spawned in a grid and selected, TransformActor is driven by the synthetic input
+and the time, the allocations and the scene queries of each update are measured. The results are written to the CSV file.
+If the baseline is given, the median time and the counts of each path are compared with it and the paths worse than the baseline by more than Tolerance are logged as errors.
+The mouse paths are driven by the virtual cursor and the cursor ray, so they run without a viewport.
+With Quit the application exits with the code 1 if the benchmark fails and 0 otherwise.
+*/
+class FTransformationActorsBenchmark
+{
+public:
+
+	/*Result of one path for one number of actors.*/
+	struct FResult
+	{
+		FString Path;
+		int32 NumActors;
+		int32 NumUpdates;
+		double MeanUs;
+		double MedianUs;
+		double P95Us;
+		double MaxUs;
+		bool bIsSkipped;
+		/*Mean counts of one update. -1 if unknown.*/
+		double AllocationsPerUpdate;
+		double QueriesPerUpdate;
+	};
+
+	/*Run the benchmark. Return false if a regression is found or the benchmark can't run.*/
+	static bool Run(UWorld* World, const FString& Params, FOutputDevice& Ar);
+
+private:
+
+	/*Measure all paths for the number of actors.*/
+	static void RunForActors(UWorld* World, int32 NumActors, int32 NumUpdates, TArray<FResult>& OutResults);
+
+	/*Call the update NumUpdates times and make the result from the times.*/
+	static FResult Measure(const FString& Path, int32 NumActors, int32 NumUpdates, TFunctionRef<bool(int32)> Update);
+
+	static bool WriteCsv(const FString& FileName, const TArray<FResult>& Results);
+	static bool ReadCsv(const FString& FileName, TArray<FResult>& OutResults);
+
+	/*Return the number of the regressions.*/
+	static int32 CompareWithBaseline(const TArray<FResult>& Results, const TArray<FResult>& Baseline, float Tolerance, FOutputDevice& Ar);
+};
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,102 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsChanges.h"
+#include "GameFramework/Actor.h"
+
+void FTransformationActorsChangeTracker::Seed(AActor* Actor)
+{
+	if (Actor && !KnownTransforms.Contains(Actor))
+	{
+		KnownTransforms.Add(Actor, Actor->GetActorTransform());
+	}
+}
+
+void FTransformationActorsChangeTracker::Seed(const TArray<AActor*>& Actors)
+{
+	for (AActor* Actor : Actors)
+	{
+		Seed(Actor);
+	}
+}
+
+void FTransformationActorsChangeTracker::MarkChanged(AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	bool bIsAlreadyChanged = false;
+	ChangedActorSet.Add(Actor, &bIsAlreadyChanged);
+	if (!bIsAlreadyChanged)
+	{
+		ChangedActors.Add(Actor);
+	}
+}
+
+void FTransformationActorsChangeTracker::MarkChanged(const TArray<AActor*>& Actors)
+{
+	for (AActor* Actor : Actors)
+	{
+		MarkChanged(Actor);
+	}
+}
+
+void FTransformationActorsChangeTracker::Collect(TArray<FTransformationActorsChange>& OutChanges, FBox& OutBounds)
+{
+	OutChanges.Reset(ChangedActors.Num());
+	OutBounds = FBox(ForceInit);
+
+	for (const TWeakObjectPtr<AActor>& WeakActor : ChangedActors)
+	{
+		AActor* Actor = WeakActor.Get();
+		if (Actor == nullptr)
+		{
+			KnownTransforms.Remove(WeakActor);
+			continue;
+		}
+
+		const FTransform NewTransform = Actor->GetActorTransform();
+
+		FTransform* KnownTransform = KnownTransforms.Find(WeakActor);
+		if (KnownTransform == nullptr)
+		{
+			KnownTransform = &KnownTransforms.Add(WeakActor, NewTransform);
+		}
+		else if (KnownTransform->Equals(NewTransform, KINDA_SMALL_NUMBER))
+		{
+			continue;
+		}
+
+		FTransformationActorsChange& Change = OutChanges[OutChanges.AddUninitialized()];
+		Change.Actor = Actor;
+		Change.OldTransform = *KnownTransform;
+		Change.NewTransform = NewTransform;
+
+		OutBounds += NewTransform.GetLocation();
+		*KnownTransform = NewTransform;
+	}
+
+	ChangedActors.Reset();
+	ChangedActorSet.Reset();
+}
+
+void FTransformationActorsChangeTracker::Retain(TFunctionRef<bool(AActor*)> IsKept)
+{
+	for (auto It = KnownTransforms.CreateIterator(); It; ++It)
+	{
+		AActor* Actor = It.Key().Get();
+		if (Actor == nullptr || !IsKept(Actor))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FTransformationActorsChangeTracker::Empty()
+{
+	KnownTransforms.Empty();
+	ChangedActors.Empty();
+	ChangedActorSet.Empty();
+}
@@ -0,0 +1,107 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsCommandQueue.h"
+#include "Async/Async.h"
+#include "GameFramework/Actor.h"
+
+FTransformationActorsMergedCommand::FTransformationActorsMergedCommand()
+	: bHasTransform(false)
+	, Transform(FTransform::Identity)
+	, DeltaLocation(FVector::ZeroVector)
+	, DeltaRotation(FQuat::Identity)
+	, ScaleRatio(FVector::OneVector)
+	, NumCommands(0)
+{
+}
+
+void FTransformationActorsMergedCommand::Merge(const FTransformationActorsCommand& Command)
+{
+	++NumCommands;
+
+	if (!Command.bIsRelative)
+	{
+		/*The absolute transform overrides everything before it.*/
+		bHasTransform = true;
+		Transform = Command.Transform;
+		DeltaLocation = FVector::ZeroVector;
+		DeltaRotation = FQuat::Identity;
+		ScaleRatio = FVector::OneVector;
+		return;
+	}
+
+	DeltaLocation += Command.Transform.GetLocation();
+	DeltaRotation = Command.Transform.GetRotation() * DeltaRotation;
+	ScaleRatio *= Command.Transform.GetScale3D();
+}
+
+FTransform FTransformationActorsMergedCommand::Resolve(const FTransform& CurrentTransform) const
+{
+	const FTransform& Base = bHasTransform ? Transform : CurrentTransform;
+
+	FTransform Result;
+	Result.SetLocation(Base.GetLocation() + DeltaLocation);
+	Result.SetRotation((DeltaRotation * Base.GetRotation()).GetNormalized());
+	Result.SetScale3D(Base.GetScale3D() * ScaleRatio);
+	return Result;
+}
+
+FTransformationActorsCommandQueue::FTransformationActorsCommandQueue()
+	: bIsWakeScheduled(false)
+{
+}
+
+void FTransformationActorsCommandQueue::Push(AActor* Actor, const FTransform& Transform, bool bIsRelative)
+{
+	FTransformationActorsCommand Command;
+	Command.Actor = Actor;
+	Command.Transform = Transform;
+	Command.bIsRelative = bIsRelative;
+	Queue.Enqueue(MoveTemp(Command));
+
+	/*The owner may not tick while the queue is empty, the first push wakes it up.*/
+	if (WakeFunction && !bIsWakeScheduled.AtomicSet(true))
+	{
+		TWeakPtr<FTransformationActorsCommandQueue, ESPMode::ThreadSafe> WeakQueue = AsShared();
+		AsyncTask(ENamedThreads::GameThread, [WeakQueue]()
+		{
+			TSharedPtr<FTransformationActorsCommandQueue, ESPMode::ThreadSafe> CommandQueue = WeakQueue.Pin();
+			if (CommandQueue.IsValid())
+			{
+				CommandQueue->bIsWakeScheduled = false;
+				CommandQueue->WakeFunction();
+			}
+		});
+	}
+}
+
+int32 FTransformationActorsCommandQueue::Drain(int32 MaxCommands, TArray<FTransformationActorsMergedCommand>& OutCommands)
+{
+	check(IsInGameThread());
+
+	OutCommands.Reset();
+	MergedIndexByActor.Reset();
+
+	int32 NumTaken = 0;
+	FTransformationActorsCommand Command;
+	while (NumTaken < MaxCommands && Queue.Dequeue(Command))
+	{
+		++NumTaken;
+
+		if (!Command.Actor.IsValid())
+		{
+			continue;
+		}
+
+		int32* MergedIndex = MergedIndexByActor.Find(Command.Actor);
+		if (MergedIndex == nullptr)
+		{
+			MergedIndex = &MergedIndexByActor.Add(Command.Actor, OutCommands.AddDefaulted());
+			OutCommands[*MergedIndex].Actor = Command.Actor;
+		}
+
+		OutCommands[*MergedIndex].Merge(Command);
+	}
+
+	return NumTaken;
+}
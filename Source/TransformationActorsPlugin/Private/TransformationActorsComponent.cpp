@@ -3,13 +3,26 @@
 
 #include "TransformationActorsComponent.h"
 #include "Kismet/GameplayStatics.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/Pawn.h"
+#include "GameFramework/GameModeBase.h"
+#include "Engine/NetConnection.h"
 #include "TransformationActorsInterface.h"
+#include "TransformationActorsInterfaceCache.h"
+#include "TransformationActorsInstanceProxy.h"
+#include "TransformationActorsDragProxy.h"
+#include "TransformationActorsRawMouseInput.h"
+#include "TransformationActorsSpatialIndex.h"
+#include "TransformationActorsValidator.h"
+#include "TransformationActorsStats.h"
 #include "TimerManager.h"
 #include "Camera/CameraComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/Volume.h"
+#include "HAL/PlatformTime.h"
+#include "ConvexVolume.h"
 
 // Sets default values for this component's properties
 UTransformationActorsComponent::UTransformationActorsComponent()
@@ -29,9 +42,36 @@ UTransformationActorsComponent::UTransformationActorsComponent()
 	RotationTimerDeltaTime = TimersDeltaTime;
 	ScaleTimerDeltaTime = TimersDeltaTime;
 
+	/*The tick is switched on only during the transformation in the bUseTickInsteadOfTimers mode.*/
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	bUseTickInsteadOfTimers = false;
+	bUseRawMouseInput = false;
+	bIsLocationTickActive = false;
+	bIsRotationTickActive = false;
+	bIsScaleTickActive = false;
+	RawMouseCursor = FVector2D::ZeroVector;
+	TickDeltaTime = TimersDeltaTime;
+
 	LocationSpeed = 25.f;
+	LocationSmoothingMode = ELocationSmoothingMode::ELSM_Interp;
+	LocationSmoothingTime = 0.05f;
+	LocationPredictionTime = 0.f;
+	LastLocationUpdateTime = 0.f;
 	bSweep = false;
+	SweepMode = ETransformSweepMode::ETSM_Continuous;
+	SweepTimeBudgetMs = 1.f;
 	LocationDeepSpeed = 25.f;
+	bPlaceOnSurface = false;
+	bAlignToSurfaceNormal = false;
+	SurfaceTraceChannel = ECC_Visibility;
+	DragProxyMode = ETransformDragProxyMode::ETDPM_Off;
+	DragProxyCostThresholdMs = 0.1f;
+	DragProxyComponentCostThreshold = 24;
+	DragProxyMesh = nullptr;
+	bBatchDragMovement = false;
+	bDeferDragOverlaps = false;
+	DragOverlapUpdateInterval = 0.f;
 	ScaleSpeed = 0.015f;
 	RotationSpeed = 0.5f;
 	SumInputAxisValue = 0.f;
@@ -43,26 +83,313 @@ UTransformationActorsComponent::UTransformationActorsComponent()
 	bIsShowDebugMessages = false;
 
 	LocationSpeedKeyboard = 25.f;
+	bCoalesceKeyboardInput = false;
+	PendingKeyboardLocation = FVector::ZeroVector;
+	PendingKeyboardRotation = FVector::ZeroVector;
+	PendingKeyboardScale3D = FVector::ZeroVector;
+	bIsKeyboardCommitPending = false;
+	bUseVirtualCursor = false;
+	VirtualCursor = FVector2D::ZeroVector;
+	bUseCursorRay = false;
+	CursorRayOrigin = FVector::ZeroVector;
+	CursorRayDirection = FVector::ForwardVector;
+	bIsMarqueeSelection = false;
+	MarqueeStart = FVector2D::ZeroVector;
 	RotationSpeedKeyboard = 5.f;
 	ScaleSpeedKeyboard = 0.1f;
 
 	MinScale = 0.01f;
+
+	bIsAdditiveSelection = false;
+
+	bUseSpatialIndexPicking = false;
+	bTestPickingOcclusion = false;
+
+	bUseAsyncPicking = false;
+	bIsCursorPickPending = false;
+	bIsStopRequestedDuringPick = false;
+	NumBatchPickTracesPending = 0;
+	bPickInstances = false;
+	PickedItem = INDEX_NONE;
+
+	bIsHistoryEnabled = true;
+	MaxHistoryRecords = 65536;
+
+	bIsReplicateTransformation = false;
+	NetUpdateRate = 15.f;
+	NetInterpolationSpeed = 15.f;
+	bIsNetSessionOwner = false;
+	bIsNetInterpolationActive = false;
+	LastNetUpdateTime = 0.f;
+
+	bIsServerValidationEnabled = false;
+	ValidationRequestRate = 20.f;
+	ValidationMaxDistance = 0.f;
+	bTestValidationOverlap = true;
+	ValidationOverlapChannel = ECC_WorldDynamic;
+	ValidationTestsPerFrame = 256;
+	ValidationBudgetMs = 1.f;
+	NetRequestTokens = 0.f;
+	LastNetRequestTime = 0.f;
+	bIsNetValidationPending = false;
+	bIsNetCorrectionSent = false;
+
+	SnapshotRestoreBudgetMs = 4.f;
+
+	CommandsPerFrame = 4096;
+	CommandQueue = MakeShared<FTransformationActorsCommandQueue, ESPMode::ThreadSafe>();
+	TWeakObjectPtr<UTransformationActorsComponent> WeakThis(this);
+	CommandQueue->SetWakeFunction([WeakThis]()
+	{
+		if (WeakThis.IsValid())
+		{
+			WeakThis->UpdateComponentTickEnabled();
+		}
+	});
+
+	bIsLocationSnapEnabled = false;
+	LocationSnapGrid = 10.f;
+	bIsRotationSnapEnabled = false;
+	RotationSnapStep = 15.f;
+	bIsScaleSnapEnabled = false;
+	ScaleSnapStep = 0.1f;
+	SnapSpace = ETransformationSnapSpace::ETSS_World;
+	SnapRawTransform = FTransform::Identity;
+	SnapAppliedTransform = FTransform::Identity;
 }
 
 void UTransformationActorsComponent::BeginPlay()
 {
+	Super::BeginPlay();
+
+	History.SetMaxRecords(MaxHistoryRecords);
+
+	if (bIsReplicateTransformation)
+	{
+		SetIsReplicated(true);
+
+		if (GetOwner() && GetOwner()->IsA<AController>())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: BeginPlay(): %s replicates the transformation from a controller, the other clients won't receive it. Add the component to the possessed Pawn."), *GetOwner()->GetName());
+		}
+	}
+
+	GameModeLogoutHandle = FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &UTransformationActorsComponent::OnGameModeLogout);
+}
+
+void UTransformationActorsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FGameModeEvents::GameModeLogoutEvent.Remove(GameModeLogoutHandle);
+
+	StopRawMouseInput();
+
+	if (FTransformationActorsValidator* Validator = FTransformationActorsValidator::Get(GetWorld()))
+	{
+		Validator->Cancel(this);
+	}
+
+	FlushInstanceProxies();
+	for (const TWeakObjectPtr<ATransformationActorsInstanceProxy>& Proxy : InstanceProxies)
+	{
+		if (Proxy.IsValid())
+		{
+			Proxy->Destroy();
+		}
+	}
+	InstanceProxies.Reset();
+
+	/*The proxies of the other players are dropped, their actors stay at the start transforms.*/
+	EndDragProxies();
+	OverlapDeferral.Resume();
+	for (FTransformationActorsPlayerSession& Session : PlayerSessions)
+	{
+		DragProxyPool.Append(Session.DragProxies);
+		Session.DragProxies.Reset();
+		Session.OverlapDeferral.Resume();
+		if (Session.RawMouseInput.IsValid())
+		{
+			Session.RawMouseInput->Unregister();
+			Session.RawMouseInput.Reset();
+		}
+	}
+	for (const TWeakObjectPtr<ATransformationActorsDragProxy>& Proxy : DragProxyPool)
+	{
+		if (Proxy.IsValid())
+		{
+			Proxy->Destroy();
+		}
+	}
+	DragProxyPool.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTransformationActorsComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	TRANSFORMATIONACTORS_SCOPE(Tick);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	TickDeltaTime = DeltaTime;
+
+	PrunePlayerSessions();
+
+	/*The positions added during the previous frame are traced together.*/
+	if (PickRequests.Num() > 0 && NumBatchPickTracesPending == 0)
+	{
+		FlushAsyncPickRequests();
+	}
+
+	TickPlayerSession(DeltaTime);
+
+	/*The other players are updated in the same pass, each in its own state.*/
+	for (FTransformationActorsPlayerSession& Session : PlayerSessions)
+	{
+		if (Session.IsUpdateActive())
+		{
+			SwapPlayerSession(Session);
+			TickPlayerSession(DeltaTime);
+			SwapPlayerSession(Session);
+		}
+	}
+
+	/*The requests of all players are tested by the first component ticked in the frame.*/
+	if (bIsNetValidationPending)
+	{
+		FTransformationActorsValidator* Validator = FTransformationActorsValidator::Get(GetWorld());
+		if (Validator)
+		{
+			Validator->Process(ValidationTestsPerFrame, ValidationBudgetMs * 0.001);
+		}
+		bIsNetValidationPending = Validator && Validator->IsQueued(this);
+	}
+
+	/*The remote session approaches the last received delta.*/
+	if (bIsNetInterpolationActive)
+	{
+		bIsNetInterpolationActive = NetSession.Interpolate(DeltaTime, NetInterpolationSpeed);
+		MarkNetSessionChanged();
+	}
+
+	if (PendingInstanceProxies.Num() > 0)
+	{
+		FlushInstanceProxies();
+	}
+
+	if (CommandQueue->HasCommands())
+	{
+		ApplyTransformCommands();
+	}
+
+	if (Snapshot.IsRestoring())
+	{
+		const int32 NumRestoredBefore = Snapshot.GetRestoredActors().Num();
+
+		/*The transforms before the restore are the old transforms of the change event.*/
+		const bool bIsSeedChanges = IsChangeEventBound();
+		const bool bIsRestoreFinished = Snapshot.RestoreBatch(SnapshotRestoreBudgetMs * 0.001, [this, bIsSeedChanges](AActor* Actor)
+		{
+			if (bIsSeedChanges)
+			{
+				ChangeTracker.Seed(Actor);
+			}
+		});
+
+		/*The actors of each batch are marked in its frame, before the known transforms of the unused actors are forgotten.*/
+		const TArray<TWeakObjectPtr<AActor>>& AllRestoredActors = Snapshot.GetRestoredActors();
+		TArray<AActor*> RestoredActors;
+		RestoredActors.Reserve(AllRestoredActors.Num() - NumRestoredBefore);
+		for (int32 Index = NumRestoredBefore; Index < AllRestoredActors.Num(); ++Index)
+		{
+			ModifiedActors.Add(AllRestoredActors[Index]);
+			RestoredActors.Add(AllRestoredActors[Index].Get());
+		}
+		MarkActorsChanged(RestoredActors);
+
+		if (bIsRestoreFinished)
+		{
+			OnSnapshotRestored.Broadcast(AllRestoredActors.Num(), Snapshot.GetNumMissingActors());
+		}
+	}
+
+	/*The changes of the whole frame are sent after all updates of the tick.*/
+	if (ChangeTracker.HasChanges())
+	{
+		BroadcastActorChanges();
+	}
+
+	UpdateComponentTickEnabled();
+}
+
+void UTransformationActorsComponent::TickPlayerSession(float DeltaTime)
+{
+	if (bIsKeyboardCommitPending)
+	{
+		CommitKeyboardInput(DeltaTime);
+	}
+
+	if (bIsLocationTickActive)
+	{
+		LocationActor();
+	}
+	/*With the raw mouse input there is nothing to update while the mouse is still.*/
+	if (bIsRotationTickActive && !IsRawMouseInputIdle())
+	{
+		RotationActor();
+	}
+	if (bIsScaleTickActive && !IsRawMouseInputIdle())
+	{
+		ScaleActor();
+	}
+}
 
+void UTransformationActorsComponent::UpdateComponentTickEnabled()
+{
+	bool bIsNeedTick = bIsLocationTickActive
+		|| ((bIsRotationTickActive || bIsScaleTickActive) && !IsRawMouseInputIdle())
+		|| PickRequests.Num() > 0
+		|| PendingInstanceProxies.Num() > 0
+		|| bIsKeyboardCommitPending
+		|| bIsNetInterpolationActive
+		|| bIsNetValidationPending
+		|| Snapshot.IsRestoring()
+		|| CommandQueue->HasCommands()
+		|| ChangeTracker.HasChanges();
+
+	/*The states of the destroyed players are dropped in the next tick, they don't keep the tick on.*/
+	for (const FTransformationActorsPlayerSession& Session : PlayerSessions)
+	{
+		bIsNeedTick = bIsNeedTick || (Session.IsUpdateActive() && Session.PlayerController.IsValid());
+	}
 
+	if (IsComponentTickEnabled() != bIsNeedTick)
+	{
+		SetComponentTickEnabled(bIsNeedTick);
+	}
 }
 
 void UTransformationActorsComponent::StartTransformationActor()
 {
-	if (GetIsTransform() || GetTransformState() == ETransformState::ETS_Idle)
+	if (GetIsTransform() || GetTransformState() == ETransformState::ETS_Idle || GetIsCursorPickPending())
+	{
+		return;
+	}
+
+	if (GetUseAsyncPicking())
 	{
+		StartAsyncPickUnderCursor();
 		return;
 	}
 
-	AActor* FoundActor = FindActorUnderCursor();
+	StartTransformationFoundActor(FindActorUnderCursor());
+}
+
+void UTransformationActorsComponent::StartTransformationFoundActor(AActor* FoundActor)
+{
+	if (GetIsTransform() || GetTransformState() == ETransformState::ETS_Idle)
+	{
+		return;
+	}
 
 	if (FoundActor == nullptr)
 	{
@@ -72,6 +399,9 @@ void UTransformationActorsComponent::StartTransformationActor()
 		}
 		return;
 	}
+
+	FoundActor = ResolveInstanceProxy(FoundActor);
+
 	if (!CheckActorOnTransformationActorsInterface(FoundActor))
 	{
 		return;
@@ -79,6 +409,13 @@ void UTransformationActorsComponent::StartTransformationActor()
 
 	SumInputAxisValue = 0.f;
 
+	/*A click on any of the selected actors transforms the whole group, the clicked actor becomes the controlled one.*/
+	if (FoundActor != GetPreviousTransformActor() && Selection.Contains(FoundActor))
+	{
+		SetPreviousTransformActor(FoundActor);
+		SetTransformActor(FoundActor);
+	}
+
 	if (FoundActor == GetPreviousTransformActor())
 	{
 		StartTransformTimer(GetTransformState());
@@ -92,10 +429,33 @@ void UTransformationActorsComponent::StartTransformationActor()
 
 void UTransformationActorsComponent::StopTransformationActor()
 {
+	/*The transformation is stopped right after the async trace under the cursor is finished.*/
+	if (GetIsCursorPickPending())
+	{
+		bIsStopRequestedDuringPick = true;
+		return;
+	}
+
+	/*Only the transformation by the cursor captures the start transforms of the selected actors for the release sweep.*/
+	const bool bIsTransformStopped = GetIsTransform();
+
 	if (GetTransformState() != ETransformState::ETS_Idle)
 	{
+		EndDragProxies();
+
 		OnStopTransformationActor.Broadcast();
-		StopTransformation_TransformationActorsInterface(GetTransformActor());
+
+		TArray<AActor*> SelectedActors;
+		Selection.GetActors(SelectedActors);
+		for (AActor* SelectedActor : SelectedActors)
+		{
+			StopTransformation_TransformationActorsInterface(SelectedActor);
+		}
+
+		if (GetIsTransform())
+		{
+			DEC_DWORD_STAT(STAT_TransformationActors_ActiveSessions);
+		}
 		SetIsTransform(false);
 	}
 	if (GetTransformState() == ETransformState::ETS_Location)
@@ -117,6 +477,19 @@ void UTransformationActorsComponent::StopTransformationActor()
 		SetIsLockFirstIterationScaleTimer(false);
 		StopScaleTimer();
 	}
+
+	if (bIsTransformStopped && bSweep && SweepMode == ETransformSweepMode::ETSM_OnRelease)
+	{
+		SweepSelectionOnRelease();
+	}
+
+	EndNetSession();
+
+	/*The overlaps are updated at the final place after all moves of the session.*/
+	OverlapDeferral.Resume();
+
+	/*One entry of the undo history for the whole session.*/
+	EndHistoryTransaction();
 }
 
 
@@ -174,6 +547,12 @@ void UTransformationActorsComponent::LocationLeftRightKeyboard(float AxisValue)
 
 	FVector DeltaLocation = FVector(0.f, AxisValue * LocationSpeedKeyboard, 0.f);
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(DeltaLocation, FVector::ZeroVector, FVector::ZeroVector);
+		return;
+	}
+
 	LocationKeyboardBasic(DeltaLocation);
 
 }
@@ -187,6 +566,12 @@ void UTransformationActorsComponent::LocationUpDownKeyboard(float AxisValue)
 
 	FVector DeltaLocation = FVector(0.f, 0.f, AxisValue * LocationSpeedKeyboard);
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(DeltaLocation, FVector::ZeroVector, FVector::ZeroVector);
+		return;
+	}
+
 	LocationKeyboardBasic(DeltaLocation);
 
 }
@@ -200,6 +585,12 @@ void UTransformationActorsComponent::LocationInsideOutsideKeyboard(float AxisVal
 
 	FVector DeltaLocation = FVector(AxisValue * LocationSpeedKeyboard, 0.f, 0.f);
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(DeltaLocation, FVector::ZeroVector, FVector::ZeroVector);
+		return;
+	}
+
 	LocationKeyboardBasic(DeltaLocation);
 }
 
@@ -210,6 +601,12 @@ void UTransformationActorsComponent::RotationRollKeyboard(float AxisValue)
 		return;
 	}
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(FVector::ZeroVector, FVector(AxisValue * RotationSpeedKeyboard, 0.f, 0.f), FVector::ZeroVector);
+		return;
+	}
+
 	if (GetPlayerPawn() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -240,6 +637,12 @@ void UTransformationActorsComponent::RotationPitchKeyboard(float AxisValue)
 		return;
 	}
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(FVector::ZeroVector, FVector(0.f, AxisValue * RotationSpeedKeyboard, 0.f), FVector::ZeroVector);
+		return;
+	}
+
 	if (GetPlayerPawn() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -270,6 +673,12 @@ void UTransformationActorsComponent::RotationYawKeyboard(float AxisValue)
 		return;
 	}
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(FVector::ZeroVector, FVector(0.f, 0.f, AxisValue * RotationSpeedKeyboard), FVector::ZeroVector);
+		return;
+	}
+
 	if (GetPlayerPawn() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -302,6 +711,12 @@ void UTransformationActorsComponent::ScaleKeyboard(float AxisValue)
 
 	FVector DeltaScale3D = FVector(AxisValue * ScaleSpeedKeyboard);
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(FVector::ZeroVector, FVector::ZeroVector, DeltaScale3D);
+		return;
+	}
+
 	ScaleKeyboardBasic(DeltaScale3D);
 }
 
@@ -314,6 +729,12 @@ void UTransformationActorsComponent::ScaleXKeyboard(float AxisValue)
 
 	FVector DeltaScaleX = FVector(AxisValue * ScaleSpeedKeyboard, 0.f, 0.f);
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(FVector::ZeroVector, FVector::ZeroVector, DeltaScaleX);
+		return;
+	}
+
 	ScaleKeyboardBasic(DeltaScaleX);
 }
 
@@ -326,6 +747,12 @@ void UTransformationActorsComponent::ScaleYKeyboard(float AxisValue)
 
 	FVector DeltaScaleY = FVector(0.f, AxisValue * ScaleSpeedKeyboard, 0.f);
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(FVector::ZeroVector, FVector::ZeroVector, DeltaScaleY);
+		return;
+	}
+
 	ScaleKeyboardBasic(DeltaScaleY);
 }
 
@@ -338,11 +765,19 @@ void UTransformationActorsComponent::ScaleZKeyboard(float AxisValue)
 
 	FVector DeltaScaleZ = FVector(0.f, 0.f, AxisValue * ScaleSpeedKeyboard);
 
+	if (bCoalesceKeyboardInput)
+	{
+		AddPendingKeyboardInput(FVector::ZeroVector, FVector::ZeroVector, DeltaScaleZ);
+		return;
+	}
+
 	ScaleKeyboardBasic(DeltaScaleZ);
 }
 
 void UTransformationActorsComponent::LocationKeyboardBasic(FVector DeltaLocation)
 {
+	TRANSFORMATIONACTORS_SCOPE(Update);
+
 	if (GetTransformActor() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -372,24 +807,25 @@ void UTransformationActorsComponent::LocationKeyboardBasic(FVector DeltaLocation
 		ComponentAxisTransform = GetPlayerPawn()->GetRootComponent()->GetComponentTransform();
 	}
 
-	FVector CurrentLocation = GetTransformActor()->GetActorLocation();
-
-	FVector CurrenLocationInComponentSpace = UKismetMathLibrary::InverseTransformLocation(ComponentAxisTransform, CurrentLocation);
-
-	FVector NewLocationInComponentSpace = CurrenLocationInComponentSpace + DeltaLocation;
+	FTransformationActorsMovementBatch MovementBatch;
+	BeginMovementUpdate(MovementBatch);
 
-	FTransform NewTransformInComponentSpace = FTransform(NewLocationInComponentSpace);
-
-	FTransform NewTransform = UKismetMathLibrary::ComposeTransforms(NewTransformInComponentSpace, ComponentAxisTransform);
+	FVector CurrentLocation = GetTransformActor()->GetActorLocation();
 
-	FVector NewLocation = NewTransform.GetTranslation();
+	/*Moving by DeltaLocation in the space of the component is moving by the transformed vector in world space.*/
+	AddTransformActorLocation(ComponentAxisTransform.TransformVector(DeltaLocation));
 
-	GetTransformActor()->SetActorLocation(NewLocation, bSweep);
+	/*The rest of the selected actors follow TransformActor.*/
+	Selection.ApplyDeltaLocation(GetTransformActor()->GetActorLocation() - CurrentLocation, IsContinuousSweep(), GetTransformActor());
 
+	AddActorsMovedStat();
+	MarkSelectionModified();
 }
 
 void UTransformationActorsComponent::RotationKeyboardBasic(float AxisValue, FVector Axe)
 {
+	TRANSFORMATIONACTORS_SCOPE(Update);
+
 	if (GetTransformActor() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -404,11 +840,25 @@ void UTransformationActorsComponent::RotationKeyboardBasic(float AxisValue, FVec
 
 	FQuat DeltaRotationQ = FQuat(Axe, DeltaRadian);
 
-	GetTransformActor()->AddActorWorldRotation(DeltaRotationQ, bSweep);
+	FTransformationActorsMovementBatch MovementBatch;
+	BeginMovementUpdate(MovementBatch);
+
+	FQuat CurrentRotationQ = GetTransformActor()->GetActorQuat();
+
+	AddTransformActorRotation(DeltaRotationQ);
+
+	/*The rest of the selected actors rotate around TransformActor.*/
+	FQuat AppliedDeltaRotationQ = GetTransformActor()->GetActorQuat() * CurrentRotationQ.Inverse();
+	Selection.ApplyDeltaRotation(AppliedDeltaRotationQ, GetTransformActor()->GetActorLocation(), IsContinuousSweep(), GetTransformActor());
+
+	AddActorsMovedStat();
+	MarkSelectionModified();
 }
 
 void UTransformationActorsComponent::ScaleKeyboardBasic(FVector DeltaScale3D)
 {
+	TRANSFORMATIONACTORS_SCOPE(Update);
+
 	if (GetTransformActor() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -418,18 +868,170 @@ void UTransformationActorsComponent::ScaleKeyboardBasic(FVector DeltaScale3D)
 		return;
 	}
 
+	FTransformationActorsMovementBatch MovementBatch;
+	BeginMovementUpdate(MovementBatch);
+
+	FVector GroupDeltaScale3D = AddTransformActorScale(DeltaScale3D);
+
+	Selection.ApplyDeltaScale(GroupDeltaScale3D, MinScale, GetTransformActor());
+
+	AddActorsMovedStat();
+	MarkSelectionModified();
+}
+
+FVector UTransformationActorsComponent::AddTransformActorScale(const FVector& DeltaScale3D)
+{
+	TRANSFORMATIONACTORS_SCOPE(TransformComposition);
+
+	UpdateSnapper();
+
 	FVector CurrentScale3D = GetTransformActor()->GetActorScale3D();
 
-	FVector NewScale3DKeyboard = CurrentScale3D + DeltaScale3D;
+	/*With the snapping the input is accumulated in the raw scale.*/
+	FVector RawScale3D = Snapper.IsScaleSnapEnabled() ? SyncSnapRawTransform().GetScale3D() : CurrentScale3D;
+
+	FVector NewScale3DKeyboard = RawScale3D + DeltaScale3D;
 
 	/*Limit the minimum scale.*/
 	if (NewScale3DKeyboard.X <= MinScale || NewScale3DKeyboard.Y <= MinScale || NewScale3DKeyboard.Z <= MinScale)
 	{
-		NewScale3DKeyboard = CurrentScale3D;
+		NewScale3DKeyboard = RawScale3D;
+	}
+
+	FVector GroupDeltaScale3D = DeltaScale3D;
+
+	if (Snapper.IsScaleSnapEnabled())
+	{
+		SnapRawTransform.SetScale3D(NewScale3DKeyboard);
+		NewScale3DKeyboard = Snapper.SnapScale(NewScale3DKeyboard);
+
+		if (NewScale3DKeyboard.X <= MinScale || NewScale3DKeyboard.Y <= MinScale || NewScale3DKeyboard.Z <= MinScale)
+		{
+			NewScale3DKeyboard = CurrentScale3D;
+		}
+
+		/*The selected actors follow the snapped steps of TransformActor.*/
+		GroupDeltaScale3D = NewScale3DKeyboard - CurrentScale3D;
 	}
 
 	GetTransformActor()->SetActorScale3D(NewScale3DKeyboard);
 
+	if (Snapper.IsScaleSnapEnabled())
+	{
+		StoreSnapAppliedTransform();
+	}
+
+	return GroupDeltaScale3D;
+}
+
+void UTransformationActorsComponent::AddPendingKeyboardInput(const FVector& DeltaLocation, const FVector& DeltaRotation, const FVector& DeltaScale3D)
+{
+	PendingKeyboardLocation += DeltaLocation;
+	PendingKeyboardRotation += DeltaRotation;
+	PendingKeyboardScale3D += DeltaScale3D;
+
+	if (!bIsKeyboardCommitPending)
+	{
+		bIsKeyboardCommitPending = true;
+		UpdateComponentTickEnabled();
+	}
+}
+
+void UTransformationActorsComponent::CommitKeyboardInput(float DeltaTime)
+{
+	TRANSFORMATIONACTORS_SCOPE(Update);
+
+	/*The keyboard speeds are the speeds per frame at 60 FPS.*/
+	const float FrameScale = DeltaTime * 60.f;
+
+	const FVector DeltaLocation = PendingKeyboardLocation * FrameScale;
+	const FVector DeltaRotation = PendingKeyboardRotation * FrameScale;
+	const FVector DeltaScale3D = PendingKeyboardScale3D * FrameScale;
+
+	PendingKeyboardLocation = FVector::ZeroVector;
+	PendingKeyboardRotation = FVector::ZeroVector;
+	PendingKeyboardScale3D = FVector::ZeroVector;
+	bIsKeyboardCommitPending = false;
+
+	AActor* Actor = GetTransformActor();
+	if (Actor == nullptr || GetPlayerPawn() == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: CommitKeyboardInput(): TransformActor or PlayerPawn is not valid."));
+		}
+		return;
+	}
+
+	/*One axis transform for all axes of the frame.*/
+	const FTransform ComponentAxisTransform = GetComponentForTransformationAxis()
+		? GetComponentForTransformationAxis()->GetComponentTransform()
+		: GetPlayerPawn()->GetRootComponent()->GetComponentTransform();
+
+	const FVector WorldDeltaLocation = ComponentAxisTransform.TransformVector(DeltaLocation);
+
+	FQuat DeltaRotationQ = FQuat::Identity;
+	if (!DeltaRotation.IsZero())
+	{
+		const FQuat AxisRotationQ = ComponentAxisTransform.GetRotation();
+		DeltaRotationQ = FQuat(AxisRotationQ.GetUpVector(), FMath::DegreesToRadians(DeltaRotation.Z))
+			* FQuat(AxisRotationQ.GetRightVector(), FMath::DegreesToRadians(DeltaRotation.Y))
+			* FQuat(AxisRotationQ.GetForwardVector(), FMath::DegreesToRadians(DeltaRotation.X));
+	}
+
+	FTransformationActorsMovementBatch MovementBatch;
+	BeginMovementUpdate(MovementBatch);
+
+	const FTransform StartTransform = Actor->GetActorTransform();
+
+	UpdateSnapper();
+
+	if (Snapper.IsSnapEnabled() || bSweep)
+	{
+		/*The snapped and swept paths move TransformActor part by part.*/
+		if (!WorldDeltaLocation.IsZero())
+		{
+			AddTransformActorLocation(WorldDeltaLocation);
+		}
+		if (!DeltaRotation.IsZero())
+		{
+			AddTransformActorRotation(DeltaRotationQ);
+		}
+		if (!DeltaScale3D.IsZero())
+		{
+			AddTransformActorScale(DeltaScale3D);
+		}
+	}
+	else
+	{
+		FQuat NewRotation = DeltaRotationQ * StartTransform.GetRotation();
+		NewRotation.Normalize();
+
+		/*Limit the minimum scale.*/
+		FVector NewScale3DKeyboard = StartTransform.GetScale3D() + DeltaScale3D;
+		if (NewScale3DKeyboard.X <= MinScale || NewScale3DKeyboard.Y <= MinScale || NewScale3DKeyboard.Z <= MinScale)
+		{
+			NewScale3DKeyboard = StartTransform.GetScale3D();
+		}
+
+		Actor->SetActorTransform(FTransform(NewRotation, StartTransform.GetLocation() + WorldDeltaLocation, NewScale3DKeyboard));
+	}
+
+	/*The selected actors follow the applied change of TransformActor in one pass.*/
+	const FTransform NewTransform = Actor->GetActorTransform();
+	const FQuat AppliedDeltaRotationQ = NewTransform.GetRotation() * StartTransform.GetRotation().Inverse();
+
+	Selection.ApplyDeltaTransform(
+		NewTransform.GetLocation() - StartTransform.GetLocation(),
+		AppliedDeltaRotationQ,
+		NewTransform.GetLocation(),
+		NewTransform.GetScale3D() - StartTransform.GetScale3D(),
+		MinScale,
+		IsContinuousSweep(),
+		Actor);
+
+	AddActorsMovedStat();
+	MarkSelectionModified();
 }
 
 void UTransformationActorsComponent::SetInputModeGameAndUI()
@@ -483,6 +1085,8 @@ void UTransformationActorsComponent::SetInputModeUIOnly()
 
 AActor* UTransformationActorsComponent::FindActorUnderCursor()
 {
+	TRANSFORMATIONACTORS_SCOPE(Picking);
+
 	if (GetPlayerController() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -493,11 +1097,49 @@ AActor* UTransformationActorsComponent::FindActorUnderCursor()
 	}
 
 	FHitResult HitResult;
-	if (GetPlayerController()->GetHitResultUnderCursor(ECC_Visibility, true, HitResult))
+
+	if (GetUseSpatialIndexPicking())
 	{
-		return HitResult.GetActor();
-	}
-	else
+		FTransformationActorsSpatialIndex* SpatialIndex = FTransformationActorsSpatialIndex::Get(GetWorld());
+		FVector WorldLocation, WorldDirection;
+
+		if (SpatialIndex == nullptr || !DeprojectCursor(WorldLocation, WorldDirection))
+		{
+			if (bIsShowDebugMessages)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("TransformationActors: FindActorUnderCursor(): the cursor ray for the spatial index is not valid."));
+			}
+			return nullptr;
+		}
+
+		FVector TraceEnd = WorldLocation + WorldDirection * GetPlayerController()->HitResultTraceDistance;
+
+		AActor* HitActor = SpatialIndex->Raycast(WorldLocation, TraceEnd, ECC_Visibility, bTestPickingOcclusion, HitResult);
+		SetPickedHit(HitResult);
+		return HitActor;
+	}
+
+	/*The ray of the remote player is traced the same way as GetHitResultUnderCursor() traces the deprojected ray.*/
+	bool bIsHit = false;
+	if (bUseCursorRay)
+	{
+		const FVector TraceEnd = CursorRayOrigin + CursorRayDirection * GetPlayerController()->HitResultTraceDistance;
+		bIsHit = GetWorld()->LineTraceSingleByChannel(HitResult, CursorRayOrigin, TraceEnd, ECC_Visibility, FCollisionQueryParams(SCENE_QUERY_STAT(ClickableTrace), true));
+	}
+	else
+	{
+		bIsHit = bUseVirtualCursor
+			? GetPlayerController()->GetHitResultAtScreenPosition(VirtualCursor, ECC_Visibility, true, HitResult)
+			: GetPlayerController()->GetHitResultUnderCursor(ECC_Visibility, true, HitResult);
+	}
+	TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+
+	if (bIsHit)
+	{
+		SetPickedHit(HitResult);
+		return HitResult.GetActor();
+	}
+	else
 	{
 		if (bIsShowDebugMessages)
 		{
@@ -508,13 +1150,209 @@ AActor* UTransformationActorsComponent::FindActorUnderCursor()
 
 }
 
+bool UTransformationActorsComponent::StartAsyncPickUnderCursor()
+{
+	TRANSFORMATIONACTORS_SCOPE(Picking);
+
+	if (GetPlayerController() == nullptr || GetWorld() == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: StartAsyncPickUnderCursor(): PlayerController or GetWorld() is not valid."));
+		}
+		return false;
+	}
+
+	FVector WorldLocation, WorldDirection;
+	if (!DeprojectCursor(WorldLocation, WorldDirection))
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: StartAsyncPickUnderCursor(): GetPlayerController()->DeprojectMousePositionToWorld(WorldLocation, WorldDirection) return false."));
+		}
+		return false;
+	}
+
+	FVector TraceEnd = WorldLocation + WorldDirection * GetPlayerController()->HitResultTraceDistance;
+
+	/*The same query as GetHitResultUnderCursor(ECC_Visibility, true, ...).*/
+	FCollisionQueryParams Params(FName(TEXT("TransformationActorsAsyncPicking")), true);
+
+	CursorPickTraceDelegate.BindUObject(this, &UTransformationActorsComponent::OnCursorPickTraceDone);
+	TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+	CursorPickTraceHandle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, WorldLocation, TraceEnd, ECC_Visibility, Params, FCollisionResponseParams::DefaultResponseParam, &CursorPickTraceDelegate);
+
+	bIsCursorPickPending = true;
+	bIsStopRequestedDuringPick = false;
+
+	return true;
+}
+
+void UTransformationActorsComponent::OnCursorPickTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (!GetIsCursorPickPending() || TraceHandle != CursorPickTraceHandle)
+	{
+		/*The trace of another player is handled in the state of that player.*/
+		for (FTransformationActorsPlayerSession& Session : PlayerSessions)
+		{
+			if (Session.bIsCursorPickPending && Session.CursorPickTraceHandle == TraceHandle)
+			{
+				SwapPlayerSession(Session);
+				OnCursorPickTraceDone(TraceHandle, TraceDatum);
+				SwapPlayerSession(Session);
+				break;
+			}
+		}
+		return;
+	}
+
+	bIsCursorPickPending = false;
+
+	AActor* FoundActor = nullptr;
+	if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+	{
+		FoundActor = TraceDatum.OutHits[0].GetActor();
+		SetPickedHit(TraceDatum.OutHits[0]);
+	}
+
+	StartTransformationFoundActor(FoundActor);
+
+	if (bIsStopRequestedDuringPick)
+	{
+		bIsStopRequestedDuringPick = false;
+		StopTransformationActor();
+	}
+}
+
+void UTransformationActorsComponent::AddAsyncPickRequest(FVector2D ScreenPosition)
+{
+	PickRequests.Add(ScreenPosition);
+	UpdateComponentTickEnabled();
+}
+
+void UTransformationActorsComponent::FlushAsyncPickRequests()
+{
+	TRANSFORMATIONACTORS_SCOPE(Picking);
+
+	if (GetPlayerController() == nullptr || GetWorld() == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: FlushAsyncPickRequests(): PlayerController or GetWorld() is not valid."));
+		}
+		/*The result still corresponds to the requests, nothing is found for each of them.*/
+		TArray<AActor*> FoundActors;
+		FoundActors.SetNumZeroed(PickRequests.Num());
+		PickRequests.Reset();
+		OnAsyncPickBatchCompleted.Broadcast(FoundActors);
+		return;
+	}
+
+	FCollisionQueryParams Params(FName(TEXT("TransformationActorsAsyncPicking")), true);
+	BatchPickTraceDelegate.BindUObject(this, &UTransformationActorsComponent::OnBatchPickTraceDone);
+
+	BatchPickTraceHandles.SetNum(PickRequests.Num());
+	BatchPickResults.Reset();
+	BatchPickResults.SetNum(PickRequests.Num());
+	NumBatchPickTracesPending = 0;
+
+	for (int32 RequestIndex = 0; RequestIndex < PickRequests.Num(); ++RequestIndex)
+	{
+		FVector WorldLocation, WorldDirection;
+		if (!GetPlayerController()->DeprojectScreenPositionToWorld(PickRequests[RequestIndex].X, PickRequests[RequestIndex].Y, WorldLocation, WorldDirection))
+		{
+			BatchPickTraceHandles[RequestIndex] = FTraceHandle();
+			continue;
+		}
+
+		FVector TraceEnd = WorldLocation + WorldDirection * GetPlayerController()->HitResultTraceDistance;
+
+		/*UserData is the index of the request in the batch.*/
+		BatchPickTraceHandles[RequestIndex] = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, WorldLocation, TraceEnd, ECC_Visibility, Params, FCollisionResponseParams::DefaultResponseParam, &BatchPickTraceDelegate, RequestIndex);
+		++NumBatchPickTracesPending;
+	}
+	TRANSFORMATIONACTORS_COUNT_QUERIES(NumBatchPickTracesPending);
+
+	/*The requests that could not be deprojected have nullptr in the result, so it corresponds to the requests also if no trace is started.*/
+	if (NumBatchPickTracesPending == 0)
+	{
+		TArray<AActor*> FoundActors;
+		FoundActors.SetNumZeroed(PickRequests.Num());
+		PickRequests.Reset();
+		OnAsyncPickBatchCompleted.Broadcast(FoundActors);
+		return;
+	}
+
+	PickRequests.Reset();
+}
+
+void UTransformationActorsComponent::OnBatchPickTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 RequestIndex = static_cast<int32>(TraceDatum.UserData);
+	if (!BatchPickTraceHandles.IsValidIndex(RequestIndex) || BatchPickTraceHandles[RequestIndex] != TraceHandle)
+	{
+		return;
+	}
+
+	BatchPickTraceHandles[RequestIndex] = FTraceHandle();
+
+	if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+	{
+		AActor* HitActor = TraceDatum.OutHits[0].GetActor();
+		if (FTransformationActorsInterfaceCache::Implements(HitActor))
+		{
+			BatchPickResults[RequestIndex] = HitActor;
+		}
+	}
+
+	if (--NumBatchPickTracesPending > 0)
+	{
+		return;
+	}
+
+	TArray<AActor*> FoundActors;
+	FoundActors.Reserve(BatchPickResults.Num());
+	for (const TWeakObjectPtr<AActor>& FoundActor : BatchPickResults)
+	{
+		FoundActors.Add(FoundActor.Get());
+	}
+
+	OnAsyncPickBatchCompleted.Broadcast(FoundActors);
+
+	/*The positions added while the batch was traced.*/
+	UpdateComponentTickEnabled();
+}
+
 void UTransformationActorsComponent::StartTransformTimer(ETransformState CurrentTransformState)
 {
 	if (CurrentTransformState != ETransformState::ETS_Idle)
 	{
+		if (!GetIsTransform())
+		{
+			INC_DWORD_STAT(STAT_TransformationActors_ActiveSessions);
+		}
 		SetIsTransform(true);
 		OnStartTransformationActor.Broadcast();
-		StartTransformation_TransformationActorsInterface(GetTransformActor());
+
+		/*TransformActor is always a part of the selected actors.*/
+		Selection.Add(GetTransformActor());
+		Selection.CaptureTransforms();
+
+		TArray<AActor*> SelectedActors;
+		Selection.GetActors(SelectedActors);
+		for (AActor* SelectedActor : SelectedActors)
+		{
+			StartTransformation_TransformationActorsInterface(SelectedActor);
+		}
+		MarkActorsModified(SelectedActors);
+		SeedActorChanges(SelectedActors);
+
+		BeginHistoryTransaction();
+		BeginNetSession();
+
+		/*The history and the interface work with the actors, the proxies replace them only for the drag.*/
+		BeginDragProxies();
+		PauseDragOverlaps();
 	}
 	if (CurrentTransformState == ETransformState::ETS_Location)
 	{
@@ -538,6 +1376,13 @@ void UTransformationActorsComponent::StartTransformTimer(ETransformState Current
 
 void UTransformationActorsComponent::StartLocationTimer()
 {
+	if (IsUpdateInTick())
+	{
+		bIsLocationTickActive = true;
+		UpdateComponentTickEnabled();
+		return;
+	}
+
 	if (GetWorld())
 	{
 		GetWorld()->GetTimerManager().SetTimer(LocationTimer, this, &UTransformationActorsComponent::LocationActor, LocationTimerDeltaTime, true);
@@ -551,6 +1396,16 @@ void UTransformationActorsComponent::StartLocationTimer()
 
 void UTransformationActorsComponent::StartRotationTimer(ETransformState CurrentTransformState)
 {
+	/*The raw mouse deltas are taken in the tick as soon as they arrive.
+	The preprocessor is registered in the tick mode too, there the still mouse lets the tick sleep.*/
+	const bool bIsRawInputStarted = StartRawMouseInput();
+	if (IsUpdateInTick() || bIsRawInputStarted)
+	{
+		bIsRotationTickActive = true;
+		UpdateComponentTickEnabled();
+		return;
+	}
+
 	if (GetWorld() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -566,6 +1421,15 @@ void UTransformationActorsComponent::StartRotationTimer(ETransformState CurrentT
 
 void UTransformationActorsComponent::StartScaleTimer()
 {
+	/*The raw mouse deltas are taken in the tick as soon as they arrive.*/
+	const bool bIsRawInputStarted = StartRawMouseInput();
+	if (IsUpdateInTick() || bIsRawInputStarted)
+	{
+		bIsScaleTickActive = true;
+		UpdateComponentTickEnabled();
+		return;
+	}
+
 	if (GetWorld())
 	{
 		GetWorld()->GetTimerManager().SetTimer(ScaleTimer, this, &UTransformationActorsComponent::ScaleActor, ScaleTimerDeltaTime, true);
@@ -579,6 +1443,8 @@ void UTransformationActorsComponent::StartScaleTimer()
 
 void UTransformationActorsComponent::LocationActor()
 {
+	TRANSFORMATIONACTORS_SCOPE(Update);
+
 	if (GetPlayerController() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -598,7 +1464,7 @@ void UTransformationActorsComponent::LocationActor()
 
 	
 	/*Translate cursor coordinates to world coordinates.*/
-	if (!GetPlayerController()->DeprojectMousePositionToWorld(WorldLocation, WorldDirection))
+	if (!DeprojectCursor(WorldLocation, WorldDirection))
 	{
 		if (bIsShowDebugMessages)
 		{
@@ -615,24 +1481,138 @@ void UTransformationActorsComponent::LocationActor()
 		*/
 		DistanceToCursorSave = FVector::Distance(GetTransformActor()->GetActorLocation(), WorldLocation);
 
+		LocationSpring.Reset(GetTransformActor()->GetActorLocation());
+		LastLocationUpdateTime = GetWorld()->GetTimeSeconds();
+
+		if (bPlaceOnSurface)
+		{
+			TArray<AActor*> SelectedActors;
+			Selection.GetActors(SelectedActors);
+			/*The actors of the proxies stay in place and must not be the surface.*/
+			for (const TWeakObjectPtr<ATransformationActorsDragProxy>& Proxy : DragProxies)
+			{
+				if (Proxy.IsValid() && Proxy->GetActor())
+				{
+					SelectedActors.Add(Proxy->GetActor());
+				}
+			}
+			SurfacePlacement.Begin(GetTransformActor(), SelectedActors, SurfaceTraceChannel);
+			SurfaceTraceDelegate.BindUObject(this, &UTransformationActorsComponent::OnSurfaceTraceDone);
+		}
+
 		SetIsLockFirstIterationLocationTimer(true);
 	}
 
+	FTransformationActorsMovementBatch MovementBatch;
+	BeginMovementUpdate(MovementBatch);
+
 	float MultiplierDistance = DistanceToCursorSave + (SumInputAxisValue * LocationDeepSpeed);
 
 	NewLocation = WorldLocation + (WorldDirection * MultiplierDistance);
 
-	/*Slightly removes jerking when moving, but the actor lags behind the cursor.*/
-	FVector InterpNewLocation = FMath::VInterpTo(GetTransformActor()->GetActorLocation(), NewLocation, LocationTimerDeltaTime, LocationSpeed);
+	/*The surface found by the previous trace is used, the trace is repeated only when the cursor ray moves.*/
+	bool bIsOnSurface = false;
+	FQuat SurfaceRotationQ = GetTransformActor()->GetActorQuat();
+	if (bPlaceOnSurface)
+	{
+		SurfacePlacement.Update(GetWorld(), WorldLocation, WorldLocation + WorldDirection * GetPlayerController()->HitResultTraceDistance, &SurfaceTraceDelegate);
+
+		if (SurfacePlacement.HasSurface())
+		{
+			if (bAlignToSurfaceNormal)
+			{
+				SurfaceRotationQ = SurfacePlacement.GetAlignedRotation();
+			}
+			NewLocation = SurfacePlacement.GetPlacedLocation(SurfaceRotationQ, GetTransformActor()->GetActorScale3D(), SumInputAxisValue * LocationDeepSpeed);
+			bIsOnSurface = true;
+		}
+	}
+
+	/*The actor is turned to the surface before the move, the selected actors rotate around it.*/
+	if (bIsOnSurface && bAlignToSurfaceNormal && !GetTransformActor()->GetActorQuat().Equals(SurfaceRotationQ, KINDA_SMALL_NUMBER))
+	{
+		FQuat CurrentRotationQ = GetTransformActor()->GetActorQuat();
+
+		AddTransformActorRotation(SurfaceRotationQ * CurrentRotationQ.Inverse());
+
+		FQuat AppliedDeltaRotationQ = GetTransformActor()->GetActorQuat() * CurrentRotationQ.Inverse();
+		Selection.ApplyDeltaRotation(AppliedDeltaRotationQ, GetTransformActor()->GetActorLocation(), IsContinuousSweep(), GetTransformActor());
+	}
+
+	/*The smoothing moves the raw location, the applied location is snapped after it, so the actor stays on the grid during the drag and after the release.*/
+	UpdateSnapper();
+	const bool bIsLocationSnapped = Snapper.IsLocationSnapEnabled();
+
+	FVector CurrentLocation = GetTransformActor()->GetActorLocation();
+	const FVector SmoothedLocation = bIsLocationSnapped ? SyncSnapRawTransform().GetLocation() : CurrentLocation;
+
+	FVector InterpNewLocation;
+
+	if (LocationSmoothingMode == ELocationSmoothingMode::ELSM_CriticallyDamped)
+	{
+		/*The time between the calls is measured, so a late timer or a long frame moves the actor as far as it must have moved.*/
+		const float CurrentTime = GetWorld()->GetTimeSeconds();
+		const float DeltaTime = CurrentTime - LastLocationUpdateTime;
+		LastLocationUpdateTime = CurrentTime;
+
+		/*The actor was stopped by the sweep or moved outside: the spring continues from the real location.*/
+		if (!LocationSpring.GetLocation().Equals(SmoothedLocation, KINDA_SMALL_NUMBER))
+		{
+			LocationSpring.Reset(SmoothedLocation);
+		}
+
+		InterpNewLocation = LocationSpring.Update(NewLocation, DeltaTime, LocationSmoothingTime, LocationPredictionTime);
+	}
+	else
+	{
+		/*In the tick mode the real frame time is used instead of the timer period.*/
+		float DeltaTime = bIsLocationTickActive ? TickDeltaTime : LocationTimerDeltaTime;
+
+		/*Slightly removes jerking when moving, but the actor lags behind the cursor.*/
+		InterpNewLocation = FMath::VInterpTo(SmoothedLocation, NewLocation, DeltaTime, LocationSpeed);
+	}
+
+	if (bIsLocationSnapped)
+	{
+		SyncSnapRawTransform().SetTranslation(InterpNewLocation);
+		SetTransformActorLocation(Snapper.SnapLocation(InterpNewLocation));
+		StoreSnapAppliedTransform();
+	}
+	else
+	{
+		SetTransformActorLocation(InterpNewLocation);
+	}
+
+	/*The rest of the selected actors follow TransformActor.*/
+	Selection.ApplyDeltaLocation(GetTransformActor()->GetActorLocation() - CurrentLocation, IsContinuousSweep(), GetTransformActor());
+
+	AddActorsMovedStat();
+	MarkSelectionChanged();
+	UpdateNetSession();
 
-	//UE_LOG(LogTemp, Warning, TEXT("Roll: %f, Pitch: %f, Yaw: %f"), Rotation.Roll, Rotation.Pitch, Rotation.Yaw);
+}
 
-	GetTransformActor()->SetActorLocation(InterpNewLocation, bSweep);
+void UTransformationActorsComponent::OnSurfaceTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (SurfacePlacement.OnTraceDone(TraceHandle, TraceDatum))
+	{
+		return;
+	}
 
+	/*The trace of another player is handled in the state of that player.*/
+	for (FTransformationActorsPlayerSession& Session : PlayerSessions)
+	{
+		if (Session.SurfacePlacement.OnTraceDone(TraceHandle, TraceDatum))
+		{
+			return;
+		}
+	}
 }
 
 void UTransformationActorsComponent::RotationActor()
 {
+	TRANSFORMATIONACTORS_SCOPE(Update);
+
 	if (!CheckControllerAndPawn())
 	{
 		return;
@@ -643,11 +1623,11 @@ void UTransformationActorsComponent::RotationActor()
 		LocationX,
 		LocationY;
 
-	if (!GetPlayerController()->GetMousePosition(LocationX, LocationY))
+	if (!GetCursorPosition(LocationX, LocationY))
 	{
 		if (bIsShowDebugMessages)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: RotationActor(): GetPlayerController()->GetMousePosition(LocationX, LocationY) return false."));
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: RotationActor(): GetCursorPosition(LocationX, LocationY) return false."));
 		}
 		return;
 	}
@@ -680,59 +1660,52 @@ void UTransformationActorsComponent::RotationActor()
 		DeltaPitchRadian = FMath::DegreesToRadians(DeltaPitchDegreeTmp),
 		DeltaYawRadian = FMath::DegreesToRadians(DeltaYawDegreeTmp);
 
-	FQuat
-		DeltaRotationQRoll,
-		DeltaRotationQPitch,
-		DeltaRotationQYaw,
-		DeltaRotationQ;
-
-	FVector
-		AxeRoll,
-		AxePitch,
-		AxeYaw;
-
-	if (GetComponentForTransformationAxis())
-	{
-		AxeRoll = -GetComponentForTransformationAxis()->GetForwardVector();
-		AxePitch = -GetComponentForTransformationAxis()->GetRightVector();
-		AxeYaw = -GetComponentForTransformationAxis()->GetUpVector();
-	}
-	else
-	{
-		AxeRoll = -GetPlayerPawn()->GetActorForwardVector();
-		AxePitch = -GetPlayerPawn()->GetActorRightVector();
-		AxeYaw = -GetPlayerPawn()->GetActorUpVector();
-	}
+	FQuat DeltaRotationQ;
 
-	DeltaRotationQRoll = FQuat(AxeRoll, DeltaRollRadian);
-	DeltaRotationQPitch = FQuat(AxePitch, DeltaPitchRadian);
-	DeltaRotationQYaw = FQuat(AxeYaw, DeltaYawRadian);
+	/*The axes are the negated forward, right and up vectors, i.e. the columns of the rotation matrix of the axis component.*/
+	const FQuat AxisRotationQ = GetComponentForTransformationAxis() ? GetComponentForTransformationAxis()->GetComponentQuat() : GetPlayerPawn()->GetActorQuat();
 
+	/*Only the quaternions of the current mode are built.*/
 	switch (GetTransformState())
 	{
 	case ETransformState::ETS_Rotation_Roll :
-		DeltaRotationQ = DeltaRotationQRoll;
+		DeltaRotationQ = FQuat(-AxisRotationQ.GetForwardVector(), DeltaRollRadian);
 		break;
 	case ETransformState::ETS_Rotation_Pitch :
-		DeltaRotationQ = DeltaRotationQPitch;
+		DeltaRotationQ = FQuat(-AxisRotationQ.GetRightVector(), DeltaPitchRadian);
 		break;
 	case ETransformState::ETS_Rotation_Yaw :
-		DeltaRotationQ = DeltaRotationQYaw;
+		DeltaRotationQ = FQuat(-AxisRotationQ.GetUpVector(), DeltaYawRadian);
 		break;
 	case ETransformState::ETS_Rotation_YawPitch :
-		DeltaRotationQ = DeltaRotationQPitch * DeltaRotationQYaw;
+		DeltaRotationQ = FQuat(-AxisRotationQ.GetRightVector(), DeltaPitchRadian) * FQuat(-AxisRotationQ.GetUpVector(), DeltaYawRadian);
 		break;
 	default:
 		return;
 	}
 
-	GetTransformActor()->AddActorWorldRotation(DeltaRotationQ, bSweep);
+	FTransformationActorsMovementBatch MovementBatch;
+	BeginMovementUpdate(MovementBatch);
+
+	FQuat CurrentRotationQ = GetTransformActor()->GetActorQuat();
+
+	AddTransformActorRotation(DeltaRotationQ);
+
+	/*The rest of the selected actors rotate around TransformActor.*/
+	FQuat AppliedDeltaRotationQ = GetTransformActor()->GetActorQuat() * CurrentRotationQ.Inverse();
+	Selection.ApplyDeltaRotation(AppliedDeltaRotationQ, GetTransformActor()->GetActorLocation(), IsContinuousSweep(), GetTransformActor());
+
+	AddActorsMovedStat();
+	MarkSelectionChanged();
+	UpdateNetSession();
 
 }
 
 
 void UTransformationActorsComponent::ScaleActor()
 {
+	TRANSFORMATIONACTORS_SCOPE(Update);
+
 	if (GetPlayerController() == nullptr)
 	{
 		if (bIsShowDebugMessages)
@@ -752,11 +1725,11 @@ void UTransformationActorsComponent::ScaleActor()
 		/*Mouse path length in 2D coordinates. The larger the DeltaLocation, the larger the scale.*/
 		DeltaLocationXY;
 
-	if (!GetPlayerController()->GetMousePosition(LocationX, LocationY))
+	if (!GetCursorPosition(LocationX, LocationY))
 	{
 		if (bIsShowDebugMessages)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: ScaleActor(): GetPlayerController()->GetMousePosition(LocationX, LocationY) return false."));
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: ScaleActor(): GetCursorPosition(LocationX, LocationY) return false."));
 		}
 		return;
 	}
@@ -800,13 +1773,36 @@ void UTransformationActorsComponent::ScaleActor()
 		NewScale3D = Scale3DSave;
 	}
 
-	GetTransformActor()->SetActorScale3D(NewScale3D);
+	/*NewScale3D keeps the raw value, the actor takes the snapped one.*/
+	UpdateSnapper();
+	FVector AppliedScale3D = Snapper.SnapScale(NewScale3D);
+	if (AppliedScale3D.X <= MinScale || AppliedScale3D.Y <= MinScale || AppliedScale3D.Z <= MinScale)
+	{
+		AppliedScale3D = GetTransformActor()->GetActorScale3D();
+	}
+
+	FTransformationActorsMovementBatch MovementBatch;
+	BeginMovementUpdate(MovementBatch);
+
+	GetTransformActor()->SetActorScale3D(AppliedScale3D);
 
+	/*The rest of the selected actors are scaled in the same proportion as TransformActor.*/
+	Selection.ApplyScaleRatio(AppliedScale3D / Scale3DSave, MinScale, GetTransformActor());
+
+	AddActorsMovedStat();
+	MarkSelectionChanged();
+	UpdateNetSession();
 
 }
 
 void UTransformationActorsComponent::StopLocationTimer()
 {
+	if (bIsLocationTickActive)
+	{
+		bIsLocationTickActive = false;
+		UpdateComponentTickEnabled();
+	}
+
 	if (GetWorld())
 	{
 		GetWorld()->GetTimerManager().ClearTimer(LocationTimer);
@@ -819,6 +1815,14 @@ void UTransformationActorsComponent::StopLocationTimer()
 
 void UTransformationActorsComponent::StopRotationTimer()
 {
+	StopRawMouseInput();
+
+	if (bIsRotationTickActive)
+	{
+		bIsRotationTickActive = false;
+		UpdateComponentTickEnabled();
+	}
+
 	if (GetWorld())
 	{
 		GetWorld()->GetTimerManager().ClearTimer(RotationTimer);
@@ -831,6 +1835,14 @@ void UTransformationActorsComponent::StopRotationTimer()
 
 void UTransformationActorsComponent::StopScaleTimer()
 {
+	StopRawMouseInput();
+
+	if (bIsScaleTickActive)
+	{
+		bIsScaleTickActive = false;
+		UpdateComponentTickEnabled();
+	}
+
 	if (GetWorld())
 	{
 		GetWorld()->GetTimerManager().ClearTimer(ScaleTimer);
@@ -843,78 +1855,1770 @@ void UTransformationActorsComponent::StopScaleTimer()
 
 void UTransformationActorsComponent::SelectNewTransformActor(AActor* NewTransformActor)
 {
-	HighlightOff_TransformationActorsInterface(GetPreviousTransformActor());
-	HighlightOn_TransformationActorsInterface(NewTransformActor);
-	SetPreviousTransformActor(NewTransformActor);
-	SetTransformActor(NewTransformActor);
-}
-
-void UTransformationActorsComponent::HighlightOn_TransformationActorsInterface(AActor* Actor)
-{
-	if (Actor == nullptr)
+	if (!GetIsAdditiveSelection())
 	{
-		if (bIsShowDebugMessages)
+		if (!Selection.Contains(GetPreviousTransformActor()))
 		{
-			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: HighlightOn_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
+			HighlightOff_TransformationActorsInterface(GetPreviousTransformActor());
 		}
-		return;
+		ClearSelection();
 	}
 
-	if (Actor->GetClass()->ImplementsInterface(UTransformationActorsInterface::StaticClass()))
+	HighlightOn_TransformationActorsInterface(NewTransformActor);
+	Selection.Add(NewTransformActor);
+	if (IsChangeEventBound())
 	{
-		ITransformationActorsInterface::Execute_HighlightOn(Actor);
+		ChangeTracker.Seed(NewTransformActor);
 	}
+	SetPreviousTransformActor(NewTransformActor);
+	SetTransformActor(NewTransformActor);
 }
 
-void UTransformationActorsComponent::HighlightOff_TransformationActorsInterface(AActor* Actor)
+bool UTransformationActorsComponent::AddActorToSelection(AActor* Actor)
 {
-	if (Actor == nullptr)
+	/*The group can't be changed while it is transformed.*/
+	if (GetIsTransform() || !CheckActorOnTransformationActorsInterface(Actor))
 	{
-		if (bIsShowDebugMessages)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: HighlightOff_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
-		}
-		return;
+		return false;
 	}
 
-	if (Actor->GetClass()->ImplementsInterface(UTransformationActorsInterface::StaticClass()))
+	if (!Selection.Add(Actor))
 	{
-		ITransformationActorsInterface::Execute_HighlightOff(Actor);
+		return false;
 	}
-}
 
-void UTransformationActorsComponent::StartTransformation_TransformationActorsInterface(AActor* Actor)
-{
-	if (Actor == nullptr)
+	HighlightOn_TransformationActorsInterface(Actor);
+	if (IsChangeEventBound())
 	{
-		if (bIsShowDebugMessages)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: StartTransformation_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
-		}
-		return;
+		ChangeTracker.Seed(Actor);
 	}
 
-	if (Actor->GetClass()->ImplementsInterface(UTransformationActorsInterface::StaticClass()))
+	if (GetTransformActor() == nullptr)
 	{
-		ITransformationActorsInterface::Execute_StartTransformation(Actor);
+		SetPreviousTransformActor(Actor);
+		SetTransformActor(Actor);
 	}
 
+	return true;
 }
 
-void UTransformationActorsComponent::StopTransformation_TransformationActorsInterface(AActor* Actor)
+bool UTransformationActorsComponent::RemoveActorFromSelection(AActor* Actor)
 {
-	if (Actor == nullptr)
+	if (GetIsTransform() || !Selection.Remove(Actor))
 	{
-		if (bIsShowDebugMessages)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: StopTransformation_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
-		}
-		return;
+		return false;
 	}
 
-	if (Actor->GetClass()->ImplementsInterface(UTransformationActorsInterface::StaticClass()))
+	HighlightOff_TransformationActorsInterface(Actor);
+
+	/*Pass the control to one of the remaining actors.*/
+	if (Actor == GetTransformActor())
 	{
-		ITransformationActorsInterface::Execute_StopTransformation(Actor);
+		AActor* NewTransformActor = Selection.Num() > 0 ? Selection.GetActor(0) : nullptr;
+		SetPreviousTransformActor(NewTransformActor);
+		SetTransformActor(NewTransformActor);
+	}
+
+	return true;
+}
+
+int32 UTransformationActorsComponent::SelectActorsInScreenRect(FVector2D ScreenStart, FVector2D ScreenEnd, bool bAddToSelection)
+{
+	TRANSFORMATIONACTORS_SCOPE(Picking);
+
+	if (GetIsTransform())
+	{
+		return 0;
+	}
+
+	FTransformationActorsSpatialIndex* SpatialIndex = FTransformationActorsSpatialIndex::Get(GetWorld());
+
+	FConvexVolume Frustum;
+	if (SpatialIndex == nullptr || !MakeScreenRectFrustum(ScreenStart, ScreenEnd, Frustum))
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: SelectActorsInScreenRect(): the frustum of the rectangle can't be built."));
+		}
+		return 0;
+	}
+
+	/*The index holds only the actors that implement TransformationActorsInterface.*/
+	TArray<AActor*> FoundActors;
+	SpatialIndex->OverlapFrustum(Frustum, FoundActors);
+
+	if (!bAddToSelection)
+	{
+		ClearSelection();
+	}
+
+	int32 NumAdded = 0;
+	for (AActor* FoundActor : FoundActors)
+	{
+		if (AddActorToSelection(FoundActor))
+		{
+			++NumAdded;
+		}
+	}
+
+	return NumAdded;
+}
+
+void UTransformationActorsComponent::BeginMarqueeSelection()
+{
+	float LocationX, LocationY;
+	if (GetPlayerController() == nullptr || !GetCursorPosition(LocationX, LocationY))
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: BeginMarqueeSelection(): the cursor position is not available."));
+		}
+		return;
+	}
+
+	MarqueeStart = FVector2D(LocationX, LocationY);
+	bIsMarqueeSelection = true;
+}
+
+int32 UTransformationActorsComponent::EndMarqueeSelection(bool bAddToSelection)
+{
+	FVector2D Start, End;
+	if (!GetMarqueeSelectionRect(Start, End))
+	{
+		return 0;
+	}
+
+	bIsMarqueeSelection = false;
+	return SelectActorsInScreenRect(Start, End, bAddToSelection);
+}
+
+bool UTransformationActorsComponent::GetMarqueeSelectionRect(FVector2D& OutStart, FVector2D& OutEnd)
+{
+	float LocationX, LocationY;
+	if (!bIsMarqueeSelection || GetPlayerController() == nullptr || !GetCursorPosition(LocationX, LocationY))
+	{
+		return false;
+	}
+
+	OutStart = MarqueeStart;
+	OutEnd = FVector2D(LocationX, LocationY);
+	return true;
+}
+
+void UTransformationActorsComponent::ClearSelection()
+{
+	TArray<AActor*> SelectedActors;
+	Selection.GetActors(SelectedActors);
+	for (AActor* SelectedActor : SelectedActors)
+	{
+		HighlightOff_TransformationActorsInterface(SelectedActor);
+	}
+
+	Selection.Empty();
+	SetPreviousTransformActor(nullptr);
+	SetTransformActor(nullptr);
+}
+
+bool UTransformationActorsComponent::UndoTransformation()
+{
+	TRANSFORMATIONACTORS_SCOPE(History);
+
+	/*The history can't be changed during the transformation.*/
+	if (GetIsTransform())
+	{
+		return false;
+	}
+
+	TArray<AActor*> UndoActors;
+	History.GetUndoActors(UndoActors);
+	SeedActorChanges(UndoActors);
+
+	if (!History.Undo())
+	{
+		return false;
+	}
+
+	MarkActorsChanged(UndoActors);
+	return true;
+}
+
+bool UTransformationActorsComponent::RedoTransformation()
+{
+	TRANSFORMATIONACTORS_SCOPE(History);
+
+	if (GetIsTransform())
+	{
+		return false;
+	}
+
+	TArray<AActor*> RedoActors;
+	History.GetRedoActors(RedoActors);
+	SeedActorChanges(RedoActors);
+
+	if (!History.Redo())
+	{
+		return false;
+	}
+
+	MarkActorsChanged(RedoActors);
+	return true;
+}
+
+void UTransformationActorsComponent::BeginHistoryTransaction()
+{
+	if (!GetIsHistoryEnabled())
+	{
+		return;
+	}
+
+	TArray<AActor*> SelectedActors;
+	Selection.GetActors(SelectedActors);
+	if (GetTransformActor() && !Selection.Contains(GetTransformActor()))
+	{
+		SelectedActors.Add(GetTransformActor());
+	}
+
+	History.BeginTransaction(SelectedActors);
+}
+
+bool UTransformationActorsComponent::EndHistoryTransaction()
+{
+	TRANSFORMATIONACTORS_SCOPE(History);
+
+	return History.CommitTransaction();
+}
+
+void UTransformationActorsComponent::ClearHistory()
+{
+	History.Empty();
+}
+
+bool UTransformationActorsComponent::IsNetSessionReplicated() const
+{
+	return bIsReplicateTransformation
+		&& GetOwner()
+		&& GetOwner()->GetNetMode() != NM_Standalone;
+}
+
+void UTransformationActorsComponent::BeginNetSession()
+{
+	/*The session of another player is being replicated.*/
+	if (!IsNetSessionReplicated() || GetTransformActor() == nullptr || bIsNetSessionOwner)
+	{
+		return;
+	}
+
+	TArray<AActor*> SelectedActors;
+	Selection.GetActors(SelectedActors);
+
+	NetSession.Begin(SelectedActors, GetTransformActor());
+	bIsNetSessionOwner = true;
+	NetSessionController = GetPlayerController();
+	bIsNetInterpolationActive = false;
+	LastNetUpdateTime = GetWorld()->GetTimeSeconds();
+	LastNetDelta = FTransformationActorsNetDelta();
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		MulticastBeginNetSession(SelectedActors, GetTransformActor());
+	}
+	else
+	{
+		ServerBeginNetSession(SelectedActors, GetTransformActor());
+	}
+}
+
+void UTransformationActorsComponent::UpdateNetSession()
+{
+	TRANSFORMATIONACTORS_SCOPE(NetSession);
+
+	if (!bIsNetSessionOwner || NetSessionController != GetPlayerController() || !NetSession.IsActive() || GetTransformActor() == nullptr)
+	{
+		return;
+	}
+
+	/*The rate limit keeps the bandwidth independent from the frame rate.*/
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (CurrentTime - LastNetUpdateTime < 1.f / NetUpdateRate)
+	{
+		return;
+	}
+
+	const FTransformationActorsNetDelta Delta = FTransformationActorsNetDelta::Make(NetSession.GetPivotStartTransform(), GetTransformActor()->GetActorTransform());
+	if (Delta.Location == LastNetDelta.Location
+		&& Delta.Pitch == LastNetDelta.Pitch && Delta.Yaw == LastNetDelta.Yaw && Delta.Roll == LastNetDelta.Roll
+		&& Delta.ScaleRatio == LastNetDelta.ScaleRatio)
+	{
+		return;
+	}
+
+	LastNetUpdateTime = CurrentTime;
+	LastNetDelta = Delta;
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		MulticastUpdateNetSession(Delta);
+	}
+	else
+	{
+		ServerUpdateNetSession(Delta);
+	}
+}
+
+void UTransformationActorsComponent::EndNetSession()
+{
+	TRANSFORMATIONACTORS_SCOPE(NetSession);
+
+	if (!bIsNetSessionOwner || NetSessionController != GetPlayerController() || !NetSession.IsActive())
+	{
+		return;
+	}
+
+	FTransformationActorsNetDelta Delta;
+	if (GetTransformActor())
+	{
+		Delta = FTransformationActorsNetDelta::Make(NetSession.GetPivotStartTransform(), GetTransformActor()->GetActorTransform());
+	}
+
+	/*Actors that did not follow the delta (blocked by the sweep or the minimum scale) are sent with their full transforms.*/
+	TArray<FTransformationActorsNetTransform> Corrections;
+	NetSession.MakeCorrections(Delta, Corrections);
+
+	/*The owner snaps to the quantized result, so all machines end the session with the same transforms.*/
+	NetSession.Apply(Delta);
+	MarkNetSessionChanged();
+	FTransformationActorsNetSession::ApplyCorrections(Corrections);
+	NetSession.End();
+	bIsNetSessionOwner = false;
+	NetSessionController.Reset();
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		MulticastEndNetSession(Delta, Corrections);
+	}
+	else
+	{
+		ServerEndNetSession(Delta, Corrections);
+	}
+}
+
+bool UTransformationActorsComponent::ServerBeginNetSession_Validate(const TArray<AActor*>& Actors, AActor* PivotActor)
+{
+	/*The owner sends its selection with TransformActor in it. The actors that the server can't resolve arrive as nullptr and are skipped later.*/
+	if (Actors.Num() == 0 || (PivotActor && !Actors.Contains(PivotActor)))
+	{
+		return false;
+	}
+
+	TSet<AActor*> UniqueActors;
+	UniqueActors.Reserve(Actors.Num());
+	for (AActor* Actor : Actors)
+	{
+		bool bIsAlreadyInSet = false;
+		UniqueActors.Add(Actor, &bIsAlreadyInSet);
+		if (Actor && bIsAlreadyInSet)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UTransformationActorsComponent::ServerBeginNetSession_Implementation(const TArray<AActor*>& Actors, AActor* PivotActor)
+{
+	if (!bIsServerValidationEnabled)
+	{
+		NetSession.Begin(Actors, PivotActor);
+		MarkActorsModified(Actors);
+		SeedActorChanges(Actors);
+		MulticastBeginNetSession(Actors, PivotActor);
+		return;
+	}
+
+	/*The final transforms of the previous session are validated before the new session replaces it.*/
+	if (FTransformationActorsValidator* Validator = FTransformationActorsValidator::Get(GetWorld()))
+	{
+		Validator->Flush(this);
+	}
+	bIsNetValidationPending = false;
+
+	/*Only the actors that can be transformed by the component are accepted.*/
+	TArray<AActor*> ValidActors;
+	ValidActors.Reserve(Actors.Num());
+	for (AActor* Actor : Actors)
+	{
+		/*The other clients must be able to resolve the actors of the multicast.*/
+		const bool bIsNetAddressable = Actor && (Actor->GetIsReplicated() || Actor->IsNetStartupActor());
+		if (bIsNetAddressable && FTransformationActorsInterfaceCache::Implements(Actor))
+		{
+			ValidActors.Add(Actor);
+		}
+	}
+
+	NetSession.Begin(ValidActors, ValidActors.Contains(PivotActor) ? PivotActor : nullptr);
+	LastAcceptedNetDelta = FTransformationActorsNetDelta();
+	bIsNetCorrectionSent = false;
+
+	MarkActorsModified(ValidActors);
+	SeedActorChanges(ValidActors);
+	MulticastBeginNetSession(ValidActors, ValidActors.Contains(PivotActor) ? PivotActor : nullptr);
+}
+
+bool UTransformationActorsComponent::ServerUpdateNetSession_Validate(const FTransformationActorsNetDelta& Delta)
+{
+	return Delta.IsValid();
+}
+
+void UTransformationActorsComponent::ServerUpdateNetSession_Implementation(const FTransformationActorsNetDelta& Delta)
+{
+	/*The unreliable update can arrive after the end of the session, it is ignored then.*/
+	if (!NetSession.IsActive())
+	{
+		return;
+	}
+
+	if (bIsServerValidationEnabled)
+	{
+		/*The dropped update is replaced by the next one, they carry the whole delta since the start of the session.*/
+		if (ConsumeNetRequestToken())
+		{
+			SubmitNetRequest(Delta, TArray<FTransformationActorsNetTransform>(), false);
+		}
+		return;
+	}
+
+	NetSession.Apply(Delta);
+	MarkNetSessionChanged();
+	MulticastUpdateNetSession(Delta);
+}
+
+bool UTransformationActorsComponent::ServerEndNetSession_Validate(const FTransformationActorsNetDelta& Delta, const TArray<FTransformationActorsNetTransform>& Corrections)
+{
+	if (!Delta.IsValid())
+	{
+		return false;
+	}
+
+	/*The owner corrects only the actors of its session, each once.*/
+	if (NetSession.IsActive() && Corrections.Num() > NetSession.GetActors().Num())
+	{
+		return false;
+	}
+
+	for (const FTransformationActorsNetTransform& Correction : Corrections)
+	{
+		if (!Correction.IsValid())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UTransformationActorsComponent::ServerEndNetSession_Implementation(const FTransformationActorsNetDelta& Delta, const TArray<FTransformationActorsNetTransform>& Corrections)
+{
+	if (!NetSession.IsActive())
+	{
+		return;
+	}
+
+	/*The corrections can't move the actors outside of the session.*/
+	TArray<FTransformationActorsNetTransform> SessionCorrections = Corrections;
+	SessionCorrections.RemoveAll([this](const FTransformationActorsNetTransform& Correction)
+	{
+		return !NetSession.Contains(Correction.Actor);
+	});
+
+	if (bIsServerValidationEnabled)
+	{
+		ConsumeNetRequestToken(true);
+		SubmitNetRequest(Delta, SessionCorrections, true);
+		return;
+	}
+
+	NetSession.Apply(Delta);
+	MarkNetSessionChanged();
+	FTransformationActorsNetSession::ApplyCorrections(SessionCorrections);
+	NetSession.End();
+	MulticastEndNetSession(Delta, SessionCorrections);
+}
+
+void UTransformationActorsComponent::ClientNetSessionValidated_Implementation(bool bIsAccepted, const TArray<FTransformationActorsNetTransform>& Corrections)
+{
+	/*The actors return to the transforms accepted by the server. The cursor update continues from them.*/
+	FTransformationActorsNetSession::ApplyCorrections(Corrections);
+
+	if (bIsShowDebugMessages && !bIsAccepted)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TransformationActors: ClientNetSessionValidated(): the server has rejected the transforms, %d actors are corrected."), Corrections.Num());
+	}
+
+	OnServerValidationResult.Broadcast(bIsAccepted);
+}
+
+bool UTransformationActorsComponent::ConsumeNetRequestToken(bool bIsForced)
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	/*The bucket holds the updates of one second. It is not refilled by a new session, so a chain of short sessions can't move the actors faster than the updates.*/
+	NetRequestTokens = FMath::Min(NetRequestTokens + (CurrentTime - LastNetRequestTime) * ValidationRequestRate, ValidationRequestRate);
+	LastNetRequestTime = CurrentTime;
+
+	if (NetRequestTokens < 1.f && !bIsForced)
+	{
+		return false;
+	}
+
+	NetRequestTokens -= 1.f;
+	return true;
+}
+
+void UTransformationActorsComponent::SubmitNetRequest(const FTransformationActorsNetDelta& Delta, const TArray<FTransformationActorsNetTransform>& Corrections, bool bIsFinal)
+{
+	FTransformationActorsValidator* Validator = FTransformationActorsValidator::Get(GetWorld());
+	if (Validator == nullptr)
+	{
+		return;
+	}
+
+	FTransformationActorsValidationRequest Request;
+	Request.Delta = Delta;
+	Request.Corrections = Corrections;
+	Request.bIsFinal = bIsFinal;
+	Request.Actors = NetSession.GetActors();
+	NetSession.PredictTransforms(Delta, Request.Transforms);
+
+	/*The actors on the server stay at the transforms of the last accepted request, the distance is measured from them and not from the start of the session.*/
+	Request.AcceptedTransforms = NetSession.GetStartTransforms();
+	for (int32 Index = 0; Index < Request.Actors.Num(); ++Index)
+	{
+		if (const AActor* Actor = Request.Actors[Index].Get())
+		{
+			Request.AcceptedTransforms[Index] = Actor->GetActorTransform();
+		}
+	}
+
+	Request.Rules.MaxDistance = ValidationMaxDistance;
+	Request.Rules.MinScale = MinScale;
+	Request.Rules.bTestOverlap = bTestValidationOverlap;
+	Request.Rules.OverlapChannel = ValidationOverlapChannel;
+	for (AVolume* Volume : ValidationVolumes)
+	{
+		if (Volume)
+		{
+			Request.Rules.Volumes.Add(Volume);
+		}
+	}
+
+	/*The corrected actors are tested at their corrected transforms. A correction of an actor outside of the session rejects the request.*/
+	for (const FTransformationActorsNetTransform& Correction : Corrections)
+	{
+		const int32 Index = Request.Actors.IndexOfByKey(TWeakObjectPtr<AActor>(Correction.Actor));
+		if (Index == INDEX_NONE)
+		{
+			OnNetRequestValidated(Request, false);
+			return;
+		}
+		Request.Transforms[Index] = Correction.GetTransform();
+	}
+
+	Validator->Submit(this, MoveTemp(Request));
+
+	bIsNetValidationPending = true;
+	UpdateComponentTickEnabled();
+}
+
+void UTransformationActorsComponent::OnNetRequestValidated(const FTransformationActorsValidationRequest& Request, bool bIsAccepted)
+{
+	TRANSFORMATIONACTORS_SCOPE(NetSession);
+
+	if (!NetSession.IsActive())
+	{
+		return;
+	}
+
+	if (bIsAccepted)
+	{
+		LastAcceptedNetDelta = Request.Delta;
+		bIsNetCorrectionSent = false;
+
+		NetSession.Apply(Request.Delta);
+		MarkNetSessionChanged();
+
+		if (Request.bIsFinal)
+		{
+			FTransformationActorsNetSession::ApplyCorrections(Request.Corrections);
+			NetSession.End();
+			MulticastEndNetSession(Request.Delta, Request.Corrections);
+			ClientNetSessionValidated(true, TArray<FTransformationActorsNetTransform>());
+		}
+		else
+		{
+			MulticastUpdateNetSession(Request.Delta);
+		}
+		return;
+	}
+
+	/*The actors on the server stay at the last accepted transforms. The owner gets them once per series of the rejected updates.*/
+	if (Request.bIsFinal || !bIsNetCorrectionSent)
+	{
+		TArray<FTransformationActorsNetTransform> Corrections;
+		Corrections.Reserve(NetSession.GetActors().Num());
+		for (const TWeakObjectPtr<AActor>& Actor : NetSession.GetActors())
+		{
+			if (Actor.IsValid())
+			{
+				Corrections.Add(FTransformationActorsNetTransform::Make(Actor.Get(), Actor->GetActorTransform()));
+			}
+		}
+
+		ClientNetSessionValidated(false, Corrections);
+		bIsNetCorrectionSent = true;
+	}
+
+	if (Request.bIsFinal)
+	{
+		NetSession.End();
+		MulticastEndNetSession(LastAcceptedNetDelta, TArray<FTransformationActorsNetTransform>());
+	}
+}
+
+bool UTransformationActorsComponent::IsRemoteNetSessionReceiver() const
+{
+	/*The server has applied the session already, the owner has started it.*/
+	return GetOwnerRole() != ROLE_Authority && !bIsNetSessionOwner;
+}
+
+void UTransformationActorsComponent::MulticastBeginNetSession_Implementation(const TArray<AActor*>& Actors, AActor* PivotActor)
+{
+	if (!IsRemoteNetSessionReceiver())
+	{
+		return;
+	}
+
+	NetSession.Begin(Actors, PivotActor);
+	MarkActorsModified(Actors);
+	SeedActorChanges(Actors);
+	bIsNetInterpolationActive = false;
+}
+
+void UTransformationActorsComponent::MulticastUpdateNetSession_Implementation(const FTransformationActorsNetDelta& Delta)
+{
+	if (!IsRemoteNetSessionReceiver() || !NetSession.IsActive())
+	{
+		return;
+	}
+
+	if (NetInterpolationSpeed > 0.f)
+	{
+		NetSession.SetTarget(Delta);
+		bIsNetInterpolationActive = true;
+		UpdateComponentTickEnabled();
+	}
+	else
+	{
+		NetSession.Apply(Delta);
+		MarkNetSessionChanged();
+	}
+}
+
+void UTransformationActorsComponent::MulticastEndNetSession_Implementation(const FTransformationActorsNetDelta& Delta, const TArray<FTransformationActorsNetTransform>& Corrections)
+{
+	if (!IsRemoteNetSessionReceiver() || !NetSession.IsActive())
+	{
+		return;
+	}
+
+	/*The final transforms are applied without the interpolation.*/
+	NetSession.Apply(Delta);
+	MarkNetSessionChanged();
+	FTransformationActorsNetSession::ApplyCorrections(Corrections);
+	NetSession.End();
+	bIsNetInterpolationActive = false;
+}
+
+void UTransformationActorsComponent::MarkActorsModified(const TArray<AActor*>& Actors)
+{
+	for (AActor* Actor : Actors)
+	{
+		if (Actor)
+		{
+			ModifiedActors.Add(Actor);
+		}
+	}
+}
+
+void UTransformationActorsComponent::QueueTransformCommand(AActor* Actor, FTransform Transform, bool bIsRelative)
+{
+	CommandQueue->Push(Actor, Transform, bIsRelative);
+}
+
+void UTransformationActorsComponent::ApplyTransformCommands()
+{
+	TRANSFORMATIONACTORS_SCOPE(Commands);
+
+	/*The commands wait for the end of the transformation of the player, so they don't get into its undo record.*/
+	if (History.IsTransactionOpen())
+	{
+		return;
+	}
+
+	CommandQueue->Drain(CommandsPerFrame, MergedCommands);
+
+	TArray<AActor*> CommandActors;
+	CommandActors.Reserve(MergedCommands.Num());
+	for (const FTransformationActorsMergedCommand& Command : MergedCommands)
+	{
+		AActor* Actor = Command.Actor.Get();
+		if (Actor && CheckActorOnTransformationActorsInterface(Actor))
+		{
+			CommandActors.Add(Actor);
+		}
+		else if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: ApplyTransformCommands(): the actor of the command does not implement TransformationActorsInterface."));
+		}
+	}
+
+	if (CommandActors.Num() == 0)
+	{
+		return;
+	}
+
+	if (GetIsHistoryEnabled())
+	{
+		History.BeginTransaction(CommandActors);
+	}
+	SeedActorChanges(CommandActors);
+
+	for (AActor* Actor : CommandActors)
+	{
+		StartTransformation_TransformationActorsInterface(Actor);
+	}
+
+	int32 ActorIndex = 0;
+	for (const FTransformationActorsMergedCommand& Command : MergedCommands)
+	{
+		AActor* Actor = Command.Actor.Get();
+		if (ActorIndex >= CommandActors.Num() || Actor != CommandActors[ActorIndex])
+		{
+			continue;
+		}
+		++ActorIndex;
+
+		FTransform NewTransform = Command.Resolve(Actor->GetActorTransform());
+
+		/*The scale below MinScale is not applied, as in the transformation by the cursor.*/
+		if (NewTransform.GetScale3D().GetMin() < MinScale)
+		{
+			NewTransform.SetScale3D(Actor->GetActorScale3D());
+		}
+
+		Actor->SetActorTransform(NewTransform);
+	}
+
+	for (AActor* Actor : CommandActors)
+	{
+		StopTransformation_TransformationActorsInterface(Actor);
+	}
+
+	if (GetIsHistoryEnabled())
+	{
+		TRANSFORMATIONACTORS_SCOPE(History);
+		History.CommitTransaction();
+	}
+
+	MarkActorsModified(CommandActors);
+	MarkActorsChanged(CommandActors);
+
+	INC_DWORD_STAT_BY(STAT_TransformationActors_ActorsMoved, CommandActors.Num());
+	CSV_CUSTOM_STAT(TransformationActors, ActorsMoved, CommandActors.Num(), ECsvCustomStatOp::Accumulate);
+}
+
+void UTransformationActorsComponent::MarkSelectionModified()
+{
+	/*The drag proxies are transient, their actors are marked when the proxies are released.*/
+	if (GetTransformActor() && !GetTransformActor()->IsA<ATransformationActorsDragProxy>())
+	{
+		ModifiedActors.Add(GetTransformActor());
+	}
+
+	for (int32 Index = 0; Index < Selection.Num(); ++Index)
+	{
+		AActor* SelectedActor = Selection.GetActor(Index);
+		if (SelectedActor && !SelectedActor->IsA<ATransformationActorsDragProxy>())
+		{
+			ModifiedActors.Add(SelectedActor);
+		}
+	}
+
+	MarkSelectionChanged();
+}
+
+void UTransformationActorsComponent::SeedActorChanges(const TArray<AActor*>& Actors)
+{
+	if (IsChangeEventBound())
+	{
+		ChangeTracker.Seed(Actors);
+	}
+}
+
+void UTransformationActorsComponent::MarkActorsChanged(const TArray<AActor*>& Actors)
+{
+	if (!IsChangeEventBound())
+	{
+		return;
+	}
+
+	ChangeTracker.MarkChanged(Actors);
+
+	/*The changes outside the tick are sent in the next tick.*/
+	if (ChangeTracker.HasChanges() && !IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UTransformationActorsComponent::MarkSelectionChanged()
+{
+	if (!IsChangeEventBound())
+	{
+		return;
+	}
+
+	if (GetTransformActor() && !GetTransformActor()->IsA<ATransformationActorsDragProxy>())
+	{
+		ChangeTracker.MarkChanged(GetTransformActor());
+	}
+	for (int32 Index = 0; Index < Selection.Num(); ++Index)
+	{
+		AActor* SelectedActor = Selection.GetActor(Index);
+		if (SelectedActor && !SelectedActor->IsA<ATransformationActorsDragProxy>())
+		{
+			ChangeTracker.MarkChanged(SelectedActor);
+		}
+	}
+
+	if (ChangeTracker.HasChanges() && !IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UTransformationActorsComponent::MarkNetSessionChanged()
+{
+	if (!IsChangeEventBound())
+	{
+		return;
+	}
+
+	for (const TWeakObjectPtr<AActor>& Actor : NetSession.GetActors())
+	{
+		ChangeTracker.MarkChanged(Actor.Get());
+	}
+
+	if (ChangeTracker.HasChanges() && !IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UTransformationActorsComponent::BroadcastActorChanges()
+{
+	TRANSFORMATIONACTORS_SCOPE(ChangeEvents);
+
+	FBox ChangedBounds;
+	ChangeTracker.Collect(FrameChanges, ChangedBounds);
+
+	/*The transforms are known only for the actors that the component still transforms: the actors that left the selection or the ended session are forgotten.*/
+	ChangeTracker.Retain([this](AActor* Actor) { return IsActorInUse(Actor); });
+
+	if (FrameChanges.Num() == 0)
+	{
+		return;
+	}
+
+	OnActorsChanged.Broadcast(FrameChanges);
+	OnActorsChangedSummary.Broadcast(FrameChanges.Num(), ChangedBounds);
+}
+
+bool UTransformationActorsComponent::IsActorInUse(AActor* Actor) const
+{
+	auto IsDraggedByProxy = [Actor](const TArray<TWeakObjectPtr<ATransformationActorsDragProxy>>& Proxies)
+	{
+		return Proxies.ContainsByPredicate([Actor](const TWeakObjectPtr<ATransformationActorsDragProxy>& Proxy) { return Proxy.IsValid() && Proxy->GetActor() == Actor; });
+	};
+
+	if (Actor == GetTransformActor() || Selection.Contains(Actor) || IsDraggedByProxy(DragProxies) || NetSession.Contains(Actor))
+	{
+		return true;
+	}
+
+	/*The states of the other players are swapped out.*/
+	for (const FTransformationActorsPlayerSession& Session : PlayerSessions)
+	{
+		if (Actor == Session.TransformActor.Get() || Session.Selection.Contains(Actor) || IsDraggedByProxy(Session.DragProxies))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UTransformationActorsComponent::UpdateSnapper()
+{
+	const bool bIsWorldSpace = SnapSpace == ETransformationSnapSpace::ETSS_World || GetComponentForTransformationAxis() == nullptr;
+	const FTransform Space = bIsWorldSpace ? FTransform::Identity : GetComponentForTransformationAxis()->GetComponentTransform();
+
+	Snapper.Configure(
+		bIsLocationSnapEnabled ? LocationSnapGrid : 0.f,
+		bIsRotationSnapEnabled ? RotationSnapStep : 0.f,
+		bIsScaleSnapEnabled ? ScaleSnapStep : 0.f,
+		bIsWorldSpace,
+		Space);
+}
+
+FTransform& UTransformationActorsComponent::SyncSnapRawTransform()
+{
+	AActor* Actor = GetTransformActor();
+	if (Actor && (SnapActor.Get() != Actor || !Actor->GetActorTransform().Equals(SnapAppliedTransform, KINDA_SMALL_NUMBER)))
+	{
+		SnapActor = Actor;
+		SnapRawTransform = Actor->GetActorTransform();
+	}
+	return SnapRawTransform;
+}
+
+void UTransformationActorsComponent::StoreSnapAppliedTransform()
+{
+	if (GetTransformActor())
+	{
+		SnapAppliedTransform = GetTransformActor()->GetActorTransform();
+	}
+}
+
+void UTransformationActorsComponent::AddTransformActorLocation(const FVector& DeltaLocation)
+{
+	TRANSFORMATIONACTORS_SCOPE(TransformComposition);
+
+	UpdateSnapper();
+
+	if (!Snapper.IsLocationSnapEnabled())
+	{
+		SetTransformActorLocation(GetTransformActor()->GetActorLocation() + DeltaLocation);
+		return;
+	}
+
+	FTransform& RawTransform = SyncSnapRawTransform();
+	RawTransform.AddToTranslation(DeltaLocation);
+
+	SetTransformActorLocation(Snapper.SnapLocation(RawTransform.GetLocation()));
+	StoreSnapAppliedTransform();
+}
+
+void UTransformationActorsComponent::AddTransformActorRotation(const FQuat& DeltaRotationQ)
+{
+	TRANSFORMATIONACTORS_SCOPE(TransformComposition);
+
+	UpdateSnapper();
+
+	if (IsContinuousSweep())
+	{
+		TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+	}
+
+	if (!Snapper.IsRotationSnapEnabled())
+	{
+		GetTransformActor()->AddActorWorldRotation(DeltaRotationQ, IsContinuousSweep());
+		return;
+	}
+
+	FTransform& RawTransform = SyncSnapRawTransform();
+	FQuat RawRotation = DeltaRotationQ * RawTransform.GetRotation();
+	RawRotation.Normalize();
+	RawTransform.SetRotation(RawRotation);
+
+	GetTransformActor()->SetActorLocationAndRotation(GetTransformActor()->GetActorLocation(), Snapper.SnapRotation(RawRotation), IsContinuousSweep());
+	StoreSnapAppliedTransform();
+}
+
+void UTransformationActorsComponent::SetTransformActorLocation(const FVector& NewLocation)
+{
+	TRANSFORMATIONACTORS_SCOPE(Sweep);
+
+	AActor* Actor = GetTransformActor();
+
+	/*The OnRelease mode sweeps the moves of the transformation at its end, the moves outside of it are swept directly.*/
+	if (!bSweep || (SweepMode == ETransformSweepMode::ETSM_OnRelease && GetIsTransform()))
+	{
+		/*The plain moves of the actors are measured for the Auto drag proxy mode.*/
+		if (DragProxyMode == ETransformDragProxyMode::ETDPM_Auto && !Actor->IsA<ATransformationActorsDragProxy>())
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Actor->SetActorLocation(NewLocation, false);
+			RecordMoveCost(Actor, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+			return;
+		}
+
+		Actor->SetActorLocation(NewLocation, false);
+		return;
+	}
+
+	switch (SweepMode)
+	{
+	case ETransformSweepMode::ETSM_BoundsProxy :
+	{
+		const FVector CurrentLocation = Actor->GetActorLocation();
+		Actor->SetActorLocation(CurrentLocation + SweepBoundsProxy(Actor, NewLocation - CurrentLocation), false);
+		TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+		break;
+	}
+	case ETransformSweepMode::ETSM_Substepped :
+	{
+		/*
+		The sweep moves the shape of the root primitive, the attached primitives are teleported with it.
+		Each substep is not longer than the smallest half extent of the root primitive, so the consecutive positions of the swept shape overlap
+		and the blocking hit of a substep leaves the actor next to the obstacle, not past it. A root without the collision is not swept, it moves in one step.
+		*/
+		const UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+		const float MaxSubstepDistance = RootPrimitive && RootPrimitive->IsQueryCollisionEnabled()
+			? FMath::Max(RootPrimitive->Bounds.BoxExtent.GetMin(), 0.1f)
+			: BIG_NUMBER;
+
+		const double EndTime = FPlatformTime::Seconds() + SweepTimeBudgetMs * 0.001;
+
+		FHitResult SweepHit;
+		do
+		{
+			const FVector RemainingDelta = NewLocation - Actor->GetActorLocation();
+			const float RemainingDistance = RemainingDelta.Size();
+			if (RemainingDistance <= KINDA_SMALL_NUMBER)
+			{
+				break;
+			}
+
+			const FVector Substep = RemainingDistance > MaxSubstepDistance ? RemainingDelta * (MaxSubstepDistance / RemainingDistance) : RemainingDelta;
+			Actor->SetActorLocation(Actor->GetActorLocation() + Substep, true, &SweepHit);
+			TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+		}
+		while (!SweepHit.bBlockingHit && FPlatformTime::Seconds() < EndTime);
+		break;
+	}
+	default:
+		Actor->SetActorLocation(NewLocation, true);
+		TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+		break;
+	}
+}
+
+FVector UTransformationActorsComponent::SweepBoundsProxy(AActor* Actor, const FVector& DeltaLocation) const
+{
+	TRANSFORMATIONACTORS_SCOPE(Sweep);
+
+	if (DeltaLocation.IsNearlyZero() || GetWorld() == nullptr)
+	{
+		return DeltaLocation;
+	}
+
+	FVector Origin, Extent;
+	Actor->GetActorBounds(true, Origin, Extent);
+
+	/*The collision settings of the root primitive are used for the proxy.*/
+	ECollisionChannel TraceChannel = ECC_WorldDynamic;
+	FCollisionResponseParams ResponseParams;
+	if (const UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(Actor->GetRootComponent()))
+	{
+		TraceChannel = RootPrimitive->GetCollisionObjectType();
+		ResponseParams.CollisionResponse = RootPrimitive->GetCollisionResponseToChannels();
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TransformationActorsBoundsProxy), false, Actor);
+	for (int32 Index = 0; Index < Selection.Num(); ++Index)
+	{
+		QueryParams.AddIgnoredActor(Selection.GetActor(Index));
+	}
+	for (const TWeakObjectPtr<ATransformationActorsDragProxy>& Proxy : DragProxies)
+	{
+		if (Proxy.IsValid())
+		{
+			QueryParams.AddIgnoredActor(Proxy->GetActor());
+		}
+	}
+
+	FHitResult Hit;
+	if (!GetWorld()->SweepSingleByChannel(Hit, Origin, Origin + DeltaLocation, FQuat::Identity, TraceChannel, FCollisionShape::MakeBox(Extent), QueryParams, ResponseParams))
+	{
+		return DeltaLocation;
+	}
+
+	/*The proxy starts in penetration: the actor is not stopped, otherwise it can't get out.*/
+	if (Hit.bStartPenetrating)
+	{
+		return DeltaLocation;
+	}
+
+	return Hit.Location - Origin;
+}
+
+void UTransformationActorsComponent::SweepSelectionOnRelease()
+{
+	TRANSFORMATIONACTORS_SCOPE(Sweep);
+
+	for (int32 Index = 0; Index < Selection.Num(); ++Index)
+	{
+		AActor* Actor = Selection.GetActor(Index);
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		/*The rotation and the scale are kept, the translation from the start is swept.*/
+		const FVector FinalLocation = Actor->GetActorLocation();
+		Actor->SetActorLocation(Selection.GetStartTransform(Index).GetLocation(), false, nullptr, ETeleportType::TeleportPhysics);
+		Actor->SetActorLocation(FinalLocation, true);
+		TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+	}
+}
+
+bool UTransformationActorsComponent::DeprojectCursor(FVector& OutWorldLocation, FVector& OutWorldDirection) const
+{
+	TRANSFORMATIONACTORS_SCOPE(Deprojection);
+
+	if (bUseCursorRay)
+	{
+		OutWorldLocation = CursorRayOrigin;
+		OutWorldDirection = CursorRayDirection;
+		return true;
+	}
+
+	if (bUseVirtualCursor)
+	{
+		return GetPlayerController()->DeprojectScreenPositionToWorld(VirtualCursor.X, VirtualCursor.Y, OutWorldLocation, OutWorldDirection);
+	}
+
+	return GetPlayerController()->DeprojectMousePositionToWorld(OutWorldLocation, OutWorldDirection);
+}
+
+bool UTransformationActorsComponent::MakeScreenRectFrustum(const FVector2D& ScreenStart, const FVector2D& ScreenEnd, FConvexVolume& OutFrustum) const
+{
+	TRANSFORMATIONACTORS_SCOPE(Deprojection);
+
+	if (GetPlayerController() == nullptr)
+	{
+		return false;
+	}
+
+	/*A click without a drag selects a one pixel rectangle.*/
+	const FVector2D RectMin = ScreenStart.ComponentMin(ScreenEnd);
+	const FVector2D RectMax = ScreenStart.ComponentMax(ScreenEnd).ComponentMax(RectMin + FVector2D(1.f, 1.f));
+	const FVector2D Corners[4] = { RectMin, FVector2D(RectMax.X, RectMin.Y), RectMax, FVector2D(RectMin.X, RectMax.Y) };
+
+	FVector NearPoints[4], FarPoints[4];
+	const float FarDistance = GetPlayerController()->HitResultTraceDistance;
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		FVector Direction;
+		if (!GetPlayerController()->DeprojectScreenPositionToWorld(Corners[Index].X, Corners[Index].Y, NearPoints[Index], Direction))
+		{
+			return false;
+		}
+		FarPoints[Index] = NearPoints[Index] + Direction * FarDistance;
+	}
+
+	/*The planes face outward: a point inside the frustum is behind all of them.*/
+	const FVector Inside = (NearPoints[0] + NearPoints[2] + FarPoints[0] + FarPoints[2]) * 0.25f;
+	TArray<FPlane> Planes;
+	auto AddPlane = [&Planes, &Inside](const FVector& A, const FVector& B, const FVector& C)
+	{
+		const FPlane Plane(A, B, C);
+		Planes.Add(Plane.PlaneDot(Inside) > 0.f ? Plane.Flip() : Plane);
+	};
+
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		const int32 NextIndex = (Index + 1) % 4;
+		AddPlane(NearPoints[Index], NearPoints[NextIndex], FarPoints[Index]);
+	}
+	AddPlane(NearPoints[0], NearPoints[1], NearPoints[2]);
+	AddPlane(FarPoints[0], FarPoints[1], FarPoints[2]);
+
+	OutFrustum = FConvexVolume(Planes);
+	return true;
+}
+
+void UTransformationActorsComponent::SetPickedHit(const FHitResult& HitResult)
+{
+	PickedComponent = HitResult.GetComponent();
+	PickedItem = HitResult.Item;
+}
+
+AActor* UTransformationActorsComponent::ResolveInstanceProxy(AActor* FoundActor)
+{
+	/*The picked hit is used once, FoundActor of a later call may come from anywhere.*/
+	UInstancedStaticMeshComponent* InstanceComponent = Cast<UInstancedStaticMeshComponent>(PickedComponent.Get());
+	const int32 InstanceIndex = PickedItem;
+	PickedComponent.Reset();
+	PickedItem = INDEX_NONE;
+
+	if (!bPickInstances || InstanceComponent == nullptr || InstanceComponent->GetOwner() != FoundActor || !InstanceComponent->IsValidInstance(InstanceIndex))
+	{
+		return FoundActor;
+	}
+
+	/*The instances are transformed only if their actor may be transformed.*/
+	if (!FTransformationActorsInterfaceCache::Implements(FoundActor))
+	{
+		return FoundActor;
+	}
+
+	ATransformationActorsInstanceProxy* Proxy = GetInstanceProxy(InstanceComponent, InstanceIndex);
+	return Proxy ? Proxy : FoundActor;
+}
+
+ATransformationActorsInstanceProxy* UTransformationActorsComponent::GetInstanceProxy(UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex)
+{
+	for (const TWeakObjectPtr<ATransformationActorsInstanceProxy>& Proxy : InstanceProxies)
+	{
+		if (Proxy.IsValid() && Proxy->IsInstance(InstanceComponent, InstanceIndex))
+		{
+			return Proxy.Get();
+		}
+	}
+
+	if (GetWorld() == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	ATransformationActorsInstanceProxy* Proxy = GetWorld()->SpawnActor<ATransformationActorsInstanceProxy>(SpawnParameters);
+	if (Proxy == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (!Proxy->SetInstance(InstanceComponent, InstanceIndex))
+	{
+		Proxy->Destroy();
+		return nullptr;
+	}
+
+	Proxy->OnMoved.BindUObject(this, &UTransformationActorsComponent::OnInstanceProxyMoved);
+
+	/*The destroyed proxies are dropped here, so the array does not grow with the stale entries.*/
+	InstanceProxies.RemoveAllSwap([](const TWeakObjectPtr<ATransformationActorsInstanceProxy>& Entry) { return !Entry.IsValid(); }, false);
+	InstanceProxies.Add(Proxy);
+
+	return Proxy;
+}
+
+void UTransformationActorsComponent::OnInstanceProxyMoved(ATransformationActorsInstanceProxy* Proxy)
+{
+	if (Proxy->bIsWritePending)
+	{
+		return;
+	}
+
+	Proxy->bIsWritePending = true;
+	PendingInstanceProxies.Add(Proxy);
+	UpdateComponentTickEnabled();
+}
+
+void UTransformationActorsComponent::FlushInstanceProxies()
+{
+	TRANSFORMATIONACTORS_SCOPE(InstanceUpdate);
+
+	DirtyInstanceComponents.Reset();
+
+	for (const TWeakObjectPtr<ATransformationActorsInstanceProxy>& ProxyPtr : PendingInstanceProxies)
+	{
+		ATransformationActorsInstanceProxy* Proxy = ProxyPtr.Get();
+		if (Proxy == nullptr)
+		{
+			continue;
+		}
+
+		Proxy->bIsWritePending = false;
+		if (Proxy->WriteInstanceTransform())
+		{
+			DirtyInstanceComponents.AddUnique(Proxy->GetInstanceComponent());
+		}
+	}
+	PendingInstanceProxies.Reset();
+
+	/*One render state update per component for all instances moved in the frame.*/
+	for (UInstancedStaticMeshComponent* InstanceComponent : DirtyInstanceComponents)
+	{
+		InstanceComponent->MarkRenderStateDirty();
+	}
+}
+
+void UTransformationActorsComponent::ClearInstanceProxies()
+{
+	FlushInstanceProxies();
+
+	for (int32 Index = InstanceProxies.Num() - 1; Index >= 0; --Index)
+	{
+		ATransformationActorsInstanceProxy* Proxy = InstanceProxies[Index].Get();
+		if (Proxy && (Selection.Contains(Proxy) || Proxy == GetTransformActor() || Proxy == GetPreviousTransformActor()))
+		{
+			continue;
+		}
+
+		if (Proxy)
+		{
+			Proxy->Destroy();
+		}
+		InstanceProxies.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void UTransformationActorsComponent::BeginDragProxies()
+{
+	if (DragProxyMode == ETransformDragProxyMode::ETDPM_Off || IsNetSessionReplicated())
+	{
+		return;
+	}
+
+	TArray<AActor*> SelectedActors;
+	Selection.GetActors(SelectedActors);
+	for (AActor* SelectedActor : SelectedActors)
+	{
+		if (!ShouldUseDragProxy(SelectedActor))
+		{
+			continue;
+		}
+
+		ATransformationActorsDragProxy* Proxy = AcquireDragProxy();
+		if (Proxy == nullptr)
+		{
+			break;
+		}
+
+		Proxy->SetActor(SelectedActor, DragProxyMesh);
+		DragProxies.Add(Proxy);
+
+		Selection.Remove(SelectedActor);
+		Selection.Add(Proxy);
+		if (GetTransformActor() == SelectedActor)
+		{
+			SetTransformActor(Proxy);
+		}
+	}
+
+	if (bIsShowDebugMessages && DragProxies.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TransformationActors: BeginDragProxies(): %d actors are dragged as proxies."), DragProxies.Num());
+	}
+}
+
+void UTransformationActorsComponent::EndDragProxies()
+{
+	if (DragProxies.Num() == 0)
+	{
+		return;
+	}
+
+	/*The actors are swept from the start to the final transform, the OnRelease mode sweeps them itself.*/
+	const bool bIsCommitSweep = bSweep && SweepMode != ETransformSweepMode::ETSM_OnRelease;
+
+	for (const TWeakObjectPtr<ATransformationActorsDragProxy>& ProxyPtr : DragProxies)
+	{
+		ATransformationActorsDragProxy* Proxy = ProxyPtr.Get();
+		if (Proxy == nullptr)
+		{
+			continue;
+		}
+
+		AActor* Actor = Proxy->GetActor();
+		Selection.Remove(Proxy);
+
+		if (Actor)
+		{
+			/*The actor has not moved yet, so the selection captures its start transform.*/
+			Selection.Add(Actor);
+
+			const double StartTime = FPlatformTime::Seconds();
+			Actor->SetActorTransform(Proxy->GetActorTransform(), bIsCommitSweep, nullptr, ETeleportType::TeleportPhysics);
+			if (bIsCommitSweep)
+			{
+				TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+			}
+			RecordMoveCost(Actor, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+
+		if (GetTransformActor() == Proxy)
+		{
+			SetTransformActor(Actor);
+		}
+
+		Proxy->Release();
+		DragProxyPool.Add(Proxy);
+	}
+	DragProxies.Reset();
+
+	MarkSelectionModified();
+}
+
+bool UTransformationActorsComponent::ShouldUseDragProxy(AActor* Actor) const
+{
+	if (Actor == nullptr || Actor->IsA<ATransformationActorsInstanceProxy>() || Actor->IsA<ATransformationActorsDragProxy>())
+	{
+		return false;
+	}
+
+	if (DragProxyMode == ETransformDragProxyMode::ETDPM_Always)
+	{
+		return true;
+	}
+
+	if (const float* CostMs = MoveCostMsByActor.Find(Actor))
+	{
+		return *CostMs > DragProxyCostThresholdMs;
+	}
+
+	return ATransformationActorsDragProxy::EstimateMoveCost(Actor) > DragProxyComponentCostThreshold;
+}
+
+ATransformationActorsDragProxy* UTransformationActorsComponent::AcquireDragProxy()
+{
+	while (DragProxyPool.Num() > 0)
+	{
+		ATransformationActorsDragProxy* Proxy = DragProxyPool.Pop(false).Get();
+		if (Proxy)
+		{
+			return Proxy;
+		}
+	}
+
+	if (GetWorld() == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	return GetWorld()->SpawnActor<ATransformationActorsDragProxy>(SpawnParameters);
+}
+
+void UTransformationActorsComponent::RecordMoveCost(AActor* Actor, float CostMs)
+{
+	/*The average of the last moves, so one slow frame does not switch the actor to the proxy.*/
+	if (float* KnownCostMs = MoveCostMsByActor.Find(Actor))
+	{
+		*KnownCostMs = FMath::Lerp(*KnownCostMs, CostMs, 0.25f);
+		return;
+	}
+
+	/*The destroyed actors are dropped here, so the map does not grow with the stale entries.*/
+	if (MoveCostMsByActor.Num() >= 1024)
+	{
+		for (auto It = MoveCostMsByActor.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	MoveCostMsByActor.Add(Actor, CostMs);
+}
+
+void UTransformationActorsComponent::BeginMovementUpdate(FTransformationActorsMovementBatch& MovementBatch)
+{
+	/*The held back overlaps are updated at the current place and held back again.*/
+	if (OverlapDeferral.IsPaused() && DragOverlapUpdateInterval > 0.f
+		&& GetWorld()->GetTimeSeconds() - OverlapDeferral.GetPauseTime() >= DragOverlapUpdateInterval)
+	{
+		OverlapDeferral.Resume();
+		PauseDragOverlaps();
+	}
+
+	if (!bBatchDragMovement)
+	{
+		return;
+	}
+
+	if (GetTransformActor() && !Selection.Contains(GetTransformActor()))
+	{
+		MovementBatch.Add(GetTransformActor());
+	}
+	for (int32 Index = 0; Index < Selection.Num(); ++Index)
+	{
+		MovementBatch.Add(Selection.GetActor(Index));
+	}
+}
+
+void UTransformationActorsComponent::PauseDragOverlaps()
+{
+	if (!bDeferDragOverlaps || GetWorld() == nullptr)
+	{
+		return;
+	}
+
+	TArray<AActor*> MovedActors;
+	Selection.GetActors(MovedActors);
+	if (GetTransformActor())
+	{
+		MovedActors.AddUnique(GetTransformActor());
+	}
+
+	OverlapDeferral.Pause(MovedActors, GetWorld()->GetTimeSeconds());
+}
+
+bool UTransformationActorsComponent::StartRawMouseInput()
+{
+	/*The player with the virtual cursor doesn't use the mouse.*/
+	if (!bUseRawMouseInput || bUseVirtualCursor)
+	{
+		return false;
+	}
+
+	if (!RawMouseInput.IsValid())
+	{
+		/*The first delta after a still period switches the tick on again.*/
+		TWeakObjectPtr<UTransformationActorsComponent> WeakThis(this);
+		RawMouseInput = MakeShared<FTransformationActorsRawMouseInput>([WeakThis]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->UpdateComponentTickEnabled();
+			}
+		});
+	}
+
+	if (!RawMouseInput->Register())
+	{
+		RawMouseInput.Reset();
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: StartRawMouseInput(): Slate application is not initialized, the cursor is polled."));
+		}
+		return false;
+	}
+
+	/*Only the differences of the positions are used, so the cursor starts at zero.*/
+	RawMouseCursor = FVector2D::ZeroVector;
+	return true;
+}
+
+void UTransformationActorsComponent::StopRawMouseInput()
+{
+	if (RawMouseInput.IsValid())
+	{
+		RawMouseInput->Unregister();
+		RawMouseInput.Reset();
+	}
+}
+
+bool UTransformationActorsComponent::IsRawMouseInputIdle() const
+{
+	if (!RawMouseInput.IsValid() || RawMouseInput->HasPendingDelta())
+	{
+		return false;
+	}
+
+	/*The first update remembers the start position, so it is done without a delta.*/
+	return bIsRotationTickActive ? GetIsLockFirstIterationRotationTimer() : GetIsLockFirstIterationScaleTimer();
+}
+
+bool UTransformationActorsComponent::GetCursorPosition(float& OutLocationX, float& OutLocationY)
+{
+	if (bUseVirtualCursor)
+	{
+		OutLocationX = VirtualCursor.X;
+		OutLocationY = VirtualCursor.Y;
+		return true;
+	}
+
+	if (RawMouseInput.IsValid())
+	{
+		RawMouseCursor += RawMouseInput->ConsumeDelta();
+		OutLocationX = RawMouseCursor.X;
+		OutLocationY = RawMouseCursor.Y;
+		return true;
+	}
+
+	return GetPlayerController()->GetMousePosition(OutLocationX, OutLocationY);
+}
+
+void UTransformationActorsComponent::AddActorsMovedStat() const
+{
+	/*TransformActor is not in the selection when it is moved by the keyboard without a session.*/
+	const int32 NumMovedActors = Selection.Contains(GetTransformActor()) ? Selection.Num() : Selection.Num() + 1;
+
+	INC_DWORD_STAT_BY(STAT_TransformationActors_ActorsMoved, NumMovedActors);
+	CSV_CUSTOM_STAT(TransformationActors, ActorsMoved, NumMovedActors, ECsvCustomStatOp::Accumulate);
+}
+
+bool UTransformationActorsComponent::SaveTransformationSnapshot(const FString& FileName)
+{
+	TRANSFORMATIONACTORS_SCOPE(Snapshot);
+
+	if (!FTransformationActorsSnapshot::SaveToFile(GetModifiedActors(), FileName))
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: SaveTransformationSnapshot(): %s can't be written."), *FileName);
+		}
+		return false;
+	}
+	return true;
+}
+
+bool UTransformationActorsComponent::RestoreTransformationSnapshot(const FString& FileName)
+{
+	if (!Snapshot.BeginRestore(GetWorld(), FileName))
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: RestoreTransformationSnapshot(): %s is not valid."), *FileName);
+		}
+		UpdateComponentTickEnabled();
+		return false;
+	}
+
+	UpdateComponentTickEnabled();
+	return true;
+}
+
+void UTransformationActorsComponent::CancelTransformationSnapshotRestore()
+{
+	Snapshot.CancelRestore();
+	UpdateComponentTickEnabled();
+}
+
+TArray<AActor*> UTransformationActorsComponent::GetModifiedActors() const
+{
+	TArray<AActor*> Actors;
+	Actors.Reserve(ModifiedActors.Num());
+	for (const TWeakObjectPtr<AActor>& Actor : ModifiedActors)
+	{
+		if (Actor.IsValid())
+		{
+			Actors.Add(Actor.Get());
+		}
+	}
+	return Actors;
+}
+
+bool UTransformationActorsComponent::IsActorSelected(AActor* Actor) const
+{
+	return Selection.Contains(Actor);
+}
+
+TArray<AActor*> UTransformationActorsComponent::GetSelectedActors() const
+{
+	TArray<AActor*> SelectedActors;
+	Selection.GetActors(SelectedActors);
+	return SelectedActors;
+}
+
+AActor* UTransformationActorsComponent::GetInterfaceEventActor(AActor* Actor) const
+{
+	/*The proxy itself has no events, the owner of the instances decides how its instance is highlighted.*/
+	if (const ATransformationActorsInstanceProxy* Proxy = Cast<ATransformationActorsInstanceProxy>(Actor))
+	{
+		if (AActor* InstanceOwner = Proxy->GetInstanceOwner())
+		{
+			return InstanceOwner;
+		}
+	}
+
+	return Actor;
+}
+
+void UTransformationActorsComponent::HighlightOn_TransformationActorsInterface(AActor* Actor)
+{
+	TRANSFORMATIONACTORS_SCOPE(InterfaceDispatch);
+
+	if (Actor == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: HighlightOn_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
+		}
+		return;
+	}
+
+	/*Events without an implementation in the class of the actor are not called.*/
+	AActor* EventActor = GetInterfaceEventActor(Actor);
+	if (FTransformationActorsInterfaceCache::HasEvent(EventActor, ETransformationActorsInterfaceCaps::HighlightOn))
+	{
+		ITransformationActorsInterface::Execute_HighlightOn(EventActor);
+	}
+}
+
+void UTransformationActorsComponent::HighlightOff_TransformationActorsInterface(AActor* Actor)
+{
+	TRANSFORMATIONACTORS_SCOPE(InterfaceDispatch);
+
+	if (Actor == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: HighlightOff_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
+		}
+		return;
+	}
+
+	/*Events without an implementation in the class of the actor are not called.*/
+	AActor* EventActor = GetInterfaceEventActor(Actor);
+	if (FTransformationActorsInterfaceCache::HasEvent(EventActor, ETransformationActorsInterfaceCaps::HighlightOff))
+	{
+		ITransformationActorsInterface::Execute_HighlightOff(EventActor);
+	}
+}
+
+void UTransformationActorsComponent::StartTransformation_TransformationActorsInterface(AActor* Actor)
+{
+	TRANSFORMATIONACTORS_SCOPE(InterfaceDispatch);
+
+	if (Actor == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: StartTransformation_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
+		}
+		return;
+	}
+
+	/*Events without an implementation in the class of the actor are not called.*/
+	AActor* EventActor = GetInterfaceEventActor(Actor);
+	if (FTransformationActorsInterfaceCache::HasEvent(EventActor, ETransformationActorsInterfaceCaps::StartTransformation))
+	{
+		ITransformationActorsInterface::Execute_StartTransformation(EventActor);
+	}
+
+}
+
+void UTransformationActorsComponent::StopTransformation_TransformationActorsInterface(AActor* Actor)
+{
+	TRANSFORMATIONACTORS_SCOPE(InterfaceDispatch);
+
+	if (Actor == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: StopTransformation_TransformationActorsInterface(AActor* Actor): Actor is not valid."));
+		}
+		return;
+	}
+
+	/*Events without an implementation in the class of the actor are not called.*/
+	AActor* EventActor = GetInterfaceEventActor(Actor);
+	if (FTransformationActorsInterfaceCache::HasEvent(EventActor, ETransformationActorsInterfaceCaps::StopTransformation))
+	{
+		ITransformationActorsInterface::Execute_StopTransformation(EventActor);
 	}
 
 }
@@ -930,7 +3634,7 @@ bool UTransformationActorsComponent::CheckActorOnTransformationActorsInterface(A
 		return false;
 	}
 
-	if (Actor->GetClass()->ImplementsInterface(UTransformationActorsInterface::StaticClass()))
+	if (FTransformationActorsInterfaceCache::Implements(Actor))
 	{
 		return true;
 	}
@@ -946,9 +3650,11 @@ bool UTransformationActorsComponent::CheckActorOnTransformationActorsInterface(A
 
 void UTransformationActorsComponent::ResetTransform()
 {
-	HighlightOff_TransformationActorsInterface(GetTransformActor());
-	SetPreviousTransformActor(nullptr);
-	SetTransformActor(nullptr);
+	if (!Selection.Contains(GetTransformActor()))
+	{
+		HighlightOff_TransformationActorsInterface(GetTransformActor());
+	}
+	ClearSelection();
 	SetTransformState(ETransformState::ETS_Idle);
 }
 
@@ -977,7 +3683,22 @@ bool UTransformationActorsComponent::SpecifyControllerAndPawn()
 	UWorld* World = GetWorld();
 	if (World)
 	{
-		SetPlayerController(UGameplayStatics::GetPlayerController(World, 0));
+		/*The player of the active state, then the player that owns the component, then the first local player.*/
+		APlayerController* Controller = GetPlayerController();
+		if (Controller == nullptr)
+		{
+			Controller = Cast<APlayerController>(GetOwner());
+		}
+		if (Controller == nullptr && Cast<APawn>(GetOwner()))
+		{
+			Controller = Cast<APlayerController>(Cast<APawn>(GetOwner())->GetController());
+		}
+		if (Controller == nullptr)
+		{
+			Controller = UGameplayStatics::GetPlayerController(World, 0);
+		}
+
+		SetPlayerController(Controller);
 		if (GetPlayerController())
 		{
 			SetPlayerPawn(GetPlayerController()->GetPawnOrSpectator());
@@ -1036,5 +3757,405 @@ bool UTransformationActorsComponent::CheckControllerAndPawn()
 	return bAllValid;
 }
 
+bool UTransformationActorsComponent::ActivatePlayerSession(APlayerController* InPlayerController)
+{
+	if (InPlayerController == nullptr)
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: ActivatePlayerSession(): PlayerController is not valid."));
+		}
+		return false;
+	}
+
+	if (InPlayerController == GetPlayerController())
+	{
+		return true;
+	}
+
+	/*The session is removed when the player is destroyed.*/
+	InPlayerController->OnDestroyed.AddUniqueDynamic(this, &UTransformationActorsComponent::OnPlayerControllerDestroyed);
+
+	/*The state without a player is taken by the first player.*/
+	if (GetPlayerController() == nullptr)
+	{
+		SetPlayerController(InPlayerController);
+		SetPlayerPawn(InPlayerController->GetPawnOrSpectator());
+		return true;
+	}
+
+	int32 SessionIndex = PlayerSessions.IndexOfByPredicate([InPlayerController](const FTransformationActorsPlayerSession& Session)
+	{
+		return Session.PlayerController == InPlayerController;
+	});
+
+	if (SessionIndex == INDEX_NONE)
+	{
+		SessionIndex = PlayerSessions.AddDefaulted();
+		FTransformationActorsPlayerSession& Session = PlayerSessions[SessionIndex];
+		Session.PlayerController = InPlayerController;
+		Session.PlayerPawn = InPlayerController->GetPawnOrSpectator();
+		Session.History.SetMaxRecords(MaxHistoryRecords);
+	}
+
+	SwitchTimersToTick();
+	SwapPlayerSession(PlayerSessions[SessionIndex]);
+
+	return true;
+}
+
+void UTransformationActorsComponent::RemovePlayerSession(APlayerController* InPlayerController)
+{
+	if (InPlayerController == nullptr || (InPlayerController != GetPlayerController() && FindPlayerSession(InPlayerController) == nullptr))
+	{
+		return;
+	}
+
+	ActivatePlayerSession(InPlayerController);
+
+	SwitchOffTransformationMode();
+	ClearSelection();
+
+	/*The state of the removed player is replaced by the last stored state or by the empty one.*/
+	if (PlayerSessions.Num() > 0)
+	{
+		SwapPlayerSession(PlayerSessions.Last());
+		PlayerSessions.Pop(false);
+	}
+	else
+	{
+		FTransformationActorsPlayerSession EmptySession;
+		EmptySession.History.SetMaxRecords(MaxHistoryRecords);
+		SwapPlayerSession(EmptySession);
+	}
+
+	UpdateComponentTickEnabled();
+}
+
+TArray<APlayerController*> UTransformationActorsComponent::GetPlayerSessionControllers() const
+{
+	TArray<APlayerController*> Controllers;
+	Controllers.Reserve(PlayerSessions.Num() + 1);
+
+	if (GetPlayerController())
+	{
+		Controllers.Add(GetPlayerController());
+	}
+	for (const FTransformationActorsPlayerSession& Session : PlayerSessions)
+	{
+		if (Session.PlayerController.IsValid())
+		{
+			Controllers.Add(Session.PlayerController.Get());
+		}
+	}
+
+	return Controllers;
+}
+
+bool UTransformationActorsComponent::SetPlayerCursorPosition(APlayerController* InPlayerController, FVector2D ScreenPosition)
+{
+	if (InPlayerController == nullptr)
+	{
+		return false;
+	}
+
+	if (InPlayerController == GetPlayerController())
+	{
+		bUseVirtualCursor = true;
+		VirtualCursor = ScreenPosition;
+		return true;
+	}
+
+	FTransformationActorsPlayerSession* Session = FindPlayerSession(InPlayerController);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+
+	Session->bUseVirtualCursor = true;
+	Session->VirtualCursor = ScreenPosition;
+	return true;
+}
+
+bool UTransformationActorsComponent::SetPlayerCursorRay(APlayerController* InPlayerController, FVector RayOrigin, FVector RayDirection)
+{
+	if (InPlayerController == nullptr || RayDirection.IsNearlyZero())
+	{
+		return false;
+	}
+
+	if (InPlayerController == GetPlayerController())
+	{
+		bUseCursorRay = true;
+		CursorRayOrigin = RayOrigin;
+		CursorRayDirection = RayDirection.GetSafeNormal();
+		return true;
+	}
+
+	FTransformationActorsPlayerSession* Session = FindPlayerSession(InPlayerController);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+
+	Session->bUseCursorRay = true;
+	Session->CursorRayOrigin = RayOrigin;
+	Session->CursorRayDirection = RayDirection.GetSafeNormal();
+	return true;
+}
+
+void UTransformationActorsComponent::ReleasePlayerCursor(APlayerController* InPlayerController)
+{
+	if (InPlayerController == nullptr)
+	{
+		return;
+	}
+
+	if (InPlayerController == GetPlayerController())
+	{
+		bUseVirtualCursor = false;
+		bUseCursorRay = false;
+	}
+	else if (FTransformationActorsPlayerSession* Session = FindPlayerSession(InPlayerController))
+	{
+		Session->bUseVirtualCursor = false;
+		Session->bUseCursorRay = false;
+	}
+}
+
+bool UTransformationActorsComponent::SendCursorToServer()
+{
+	if (GetPlayerController() == nullptr || !GetPlayerController()->IsLocalController() || GetOwnerRole() == ROLE_Authority)
+	{
+		return false;
+	}
+
+	float LocationX, LocationY;
+	FVector WorldLocation, WorldDirection;
+	if (!GetCursorPosition(LocationX, LocationY) || !DeprojectCursor(WorldLocation, WorldDirection))
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: SendCursorToServer(): the cursor is not available."));
+		}
+		return false;
+	}
+
+	ServerSetPlayerCursor(FVector2D(LocationX, LocationY), WorldLocation, WorldDirection);
+	return true;
+}
+
+bool UTransformationActorsComponent::ServerSetPlayerCursor_Validate(FVector2D ScreenPosition, FVector RayOrigin, FVector RayDirection)
+{
+	return !ScreenPosition.ContainsNaN() && !RayOrigin.ContainsNaN() && !RayDirection.ContainsNaN();
+}
+
+void UTransformationActorsComponent::ServerSetPlayerCursor_Implementation(FVector2D ScreenPosition, FVector RayOrigin, FVector RayDirection)
+{
+	/*Only the controller of the connection that owns the component can call the RPC, the cursor is its cursor.*/
+	UNetConnection* Connection = GetOwner() ? GetOwner()->GetNetConnection() : nullptr;
+	APlayerController* SenderController = Connection ? Connection->PlayerController : nullptr;
+
+	if (!SetPlayerCursorPosition(SenderController, ScreenPosition) || !SetPlayerCursorRay(SenderController, RayOrigin, RayDirection))
+	{
+		if (bIsShowDebugMessages)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TransformationActors: ServerSetPlayerCursor(): the sender has no session, call ActivatePlayerSession() for it on the server."));
+		}
+	}
+}
+
+void UTransformationActorsComponent::SetMaxHistoryRecords(int32 InMaxHistoryRecords)
+{
+	MaxHistoryRecords = InMaxHistoryRecords;
+	History.SetMaxRecords(InMaxHistoryRecords);
+
+	for (FTransformationActorsPlayerSession& Session : PlayerSessions)
+	{
+		Session.History.SetMaxRecords(InMaxHistoryRecords);
+	}
+}
+
+void UTransformationActorsComponent::SwitchTimersToTick()
+{
+	if (GetWorld() == nullptr)
+	{
+		return;
+	}
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+
+	if (TimerManager.IsTimerActive(LocationTimer))
+	{
+		TimerManager.ClearTimer(LocationTimer);
+		bIsLocationTickActive = true;
+	}
+	if (TimerManager.IsTimerActive(RotationTimer))
+	{
+		TimerManager.ClearTimer(RotationTimer);
+		bIsRotationTickActive = true;
+	}
+	if (TimerManager.IsTimerActive(ScaleTimer))
+	{
+		TimerManager.ClearTimer(ScaleTimer);
+		bIsScaleTickActive = true;
+	}
+
+	UpdateComponentTickEnabled();
+}
+
+FTransformationActorsPlayerSession* UTransformationActorsComponent::FindPlayerSession(APlayerController* InPlayerController)
+{
+	return PlayerSessions.FindByPredicate([InPlayerController](const FTransformationActorsPlayerSession& Session)
+	{
+		return Session.PlayerController == InPlayerController;
+	});
+}
+
+void UTransformationActorsComponent::PrunePlayerSessions()
+{
+	for (int32 Index = PlayerSessions.Num() - 1; Index >= 0; --Index)
+	{
+		if (!PlayerSessions[Index].PlayerController.IsValid())
+		{
+			ReleasePlayerSession(PlayerSessions[Index]);
+			PlayerSessions.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	/*The active player is destroyed: its state is replaced by the last stored state or by the empty one.*/
+	if (PlayerController.IsStale())
+	{
+		FTransformationActorsPlayerSession DroppedSession;
+		DroppedSession.History.SetMaxRecords(MaxHistoryRecords);
+		SwapPlayerSession(DroppedSession);
+		ReleasePlayerSession(DroppedSession);
+
+		if (PlayerSessions.Num() > 0)
+		{
+			SwapPlayerSession(PlayerSessions.Last());
+			PlayerSessions.Pop(false);
+		}
+	}
+
+	/*The replicated session of the destroyed player can't be ended by it.*/
+	if (bIsNetSessionOwner && !NetSessionController.IsValid())
+	{
+		NetSession.End();
+		bIsNetSessionOwner = false;
+		NetSessionController.Reset();
+	}
+}
+
+void UTransformationActorsComponent::ReleasePlayerSession(FTransformationActorsPlayerSession& Session)
+{
+	for (const TWeakObjectPtr<ATransformationActorsDragProxy>& Proxy : Session.DragProxies)
+	{
+		if (Proxy.IsValid())
+		{
+			Proxy->Release();
+			DragProxyPool.Add(Proxy);
+		}
+	}
+	Session.DragProxies.Reset();
+
+	Session.OverlapDeferral.Resume();
 
+	if (Session.RawMouseInput.IsValid())
+	{
+		Session.RawMouseInput->Unregister();
+		Session.RawMouseInput.Reset();
+	}
+
+	if (Session.bIsTransform)
+	{
+		DEC_DWORD_STAT(STAT_TransformationActors_ActiveSessions);
+		Session.bIsTransform = false;
+	}
+}
+
+void UTransformationActorsComponent::OnGameModeLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+	if (GameMode && GameMode->GetWorld() == GetWorld())
+	{
+		RemovePlayerSession(Cast<APlayerController>(Exiting));
+	}
+}
+
+void UTransformationActorsComponent::OnPlayerControllerDestroyed(AActor* DestroyedActor)
+{
+	RemovePlayerSession(Cast<APlayerController>(DestroyedActor));
+}
 
+void UTransformationActorsComponent::SwapPlayerSession(FTransformationActorsPlayerSession& Session)
+{
+	Swap(PlayerController, Session.PlayerController);
+	Swap(PlayerPawn, Session.PlayerPawn);
+	Swap(ComponentForTransformationAxis, Session.ComponentForTransformationAxis);
+
+	Swap(TransformState, Session.TransformState);
+	Swap(bIsTransform, Session.bIsTransform);
+	Swap(TransformActor, Session.TransformActor);
+	Swap(PreviousTransformActor, Session.PreviousTransformActor);
+	Swap(Selection, Session.Selection);
+	Swap(History, Session.History);
+
+	Swap(bIsLocationTickActive, Session.bIsLocationTickActive);
+	Swap(bIsRotationTickActive, Session.bIsRotationTickActive);
+	Swap(bIsScaleTickActive, Session.bIsScaleTickActive);
+	Swap(bIsLockFirstIterationLocationTimer, Session.bIsLockFirstIterationLocationTimer);
+	Swap(bIsLockFirstIterationRotationTimer, Session.bIsLockFirstIterationRotationTimer);
+	Swap(bIsLockFirstIterationScaleTimer, Session.bIsLockFirstIterationScaleTimer);
+	Swap(RawMouseInput, Session.RawMouseInput);
+	Swap(RawMouseCursor, Session.RawMouseCursor);
+
+	Swap(bUseVirtualCursor, Session.bUseVirtualCursor);
+	Swap(VirtualCursor, Session.VirtualCursor);
+	Swap(bUseCursorRay, Session.bUseCursorRay);
+	Swap(CursorRayOrigin, Session.CursorRayOrigin);
+	Swap(CursorRayDirection, Session.CursorRayDirection);
+	Swap(bIsMarqueeSelection, Session.bIsMarqueeSelection);
+	Swap(MarqueeStart, Session.MarqueeStart);
+
+	Swap(CursorPickTraceHandle, Session.CursorPickTraceHandle);
+	Swap(bIsCursorPickPending, Session.bIsCursorPickPending);
+	Swap(bIsStopRequestedDuringPick, Session.bIsStopRequestedDuringPick);
+
+	Swap(PendingKeyboardLocation, Session.PendingKeyboardLocation);
+	Swap(PendingKeyboardRotation, Session.PendingKeyboardRotation);
+	Swap(PendingKeyboardScale3D, Session.PendingKeyboardScale3D);
+	Swap(bIsKeyboardCommitPending, Session.bIsKeyboardCommitPending);
+
+	Swap(SnapRawTransform, Session.SnapRawTransform);
+	Swap(SnapAppliedTransform, Session.SnapAppliedTransform);
+	Swap(SnapActor, Session.SnapActor);
+	Swap(LocationSpring, Session.LocationSpring);
+	Swap(LastLocationUpdateTime, Session.LastLocationUpdateTime);
+	Swap(SurfacePlacement, Session.SurfacePlacement);
+	Swap(DragProxies, Session.DragProxies);
+	Swap(OverlapDeferral, Session.OverlapDeferral);
+
+	Swap(RollSave, Session.RollSave);
+	Swap(PitchSave, Session.PitchSave);
+	Swap(YawSave, Session.YawSave);
+	Swap(DeltaRollDegree, Session.DeltaRollDegree);
+	Swap(DeltaPitchDegree, Session.DeltaPitchDegree);
+	Swap(DeltaYawDegree, Session.DeltaYawDegree);
+	Swap(DistanceToCursorSave, Session.DistanceToCursorSave);
+	Swap(LocationXAtClick, Session.LocationXAtClick);
+	Swap(LocationYAtClick, Session.LocationYAtClick);
+	Swap(Scale3DSave, Session.Scale3DSave);
+	Swap(NewScale3D, Session.NewScale3D);
+	Swap(SumInputAxisValue, Session.SumInputAxisValue);
+
+	Swap(bIsLocationLeftRightKeyboard, Session.bIsLocationLeftRightKeyboard);
+	Swap(bIsLocationUpDownKeyboard, Session.bIsLocationUpDownKeyboard);
+	Swap(bIsLocationInsideOutsideKeyboard, Session.bIsLocationInsideOutsideKeyboard);
+	Swap(bIsRotationRollKeyboard, Session.bIsRotationRollKeyboard);
+	Swap(bIsRotationPitchKeyboard, Session.bIsRotationPitchKeyboard);
+	Swap(bIsRotationYawKeyboard, Session.bIsRotationYawKeyboard);
+	Swap(bIsScaleKeyboard, Session.bIsScaleKeyboard);
+	Swap(bIsScaleXKeyboard, Session.bIsScaleXKeyboard);
+	Swap(bIsScaleYKeyboard, Session.bIsScaleYKeyboard);
+	Swap(bIsScaleZKeyboard, Session.bIsScaleZKeyboard);
+}
@@ -0,0 +1,127 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsDragProxy.h"
+#include "Components/BoxComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/LightComponent.h"
+#include "Engine/StaticMesh.h"
+
+ATransformationActorsDragProxy::ATransformationActorsDragProxy()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	Root->SetMobility(EComponentMobility::Movable);
+	RootComponent = Root;
+
+	/*The box has the query collision, so the bounds of the proxy are found by the collision bounds queries, but it ignores all channels.*/
+	Box = CreateDefaultSubobject<UBoxComponent>(TEXT("Box"));
+	Box->SetupAttachment(Root);
+	Box->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Box->SetCollisionResponseToAllChannels(ECR_Ignore);
+	Box->SetGenerateOverlapEvents(false);
+	Box->SetHiddenInGame(false);
+	Box->ShapeColor = FColor::Orange;
+
+	MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
+	MeshComponent->SetupAttachment(Root);
+	MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeshComponent->SetGenerateOverlapEvents(false);
+	MeshComponent->SetCastShadow(false);
+	MeshComponent->SetVisibility(false);
+}
+
+void ATransformationActorsDragProxy::SetActor(AActor* InActor, UStaticMesh* Mesh)
+{
+	Actor = InActor;
+	if (InActor == nullptr)
+	{
+		return;
+	}
+
+	FBox LocalBounds = InActor->CalculateComponentsBoundingBoxInLocalSpace(true);
+	if (!LocalBounds.IsValid)
+	{
+		LocalBounds = FBox(FVector(-1.f), FVector(1.f));
+	}
+
+	SetActorTransform(InActor->GetActorTransform(), false, nullptr, ETeleportType::TeleportPhysics);
+
+	Box->SetRelativeLocation(LocalBounds.GetCenter());
+	Box->SetBoxExtent(LocalBounds.GetExtent().ComponentMax(FVector(1.f)));
+
+	/*The mesh is stretched to the bounds of the actor.*/
+	const FBox MeshBounds = Mesh ? Mesh->GetBoundingBox() : FBox(ForceInit);
+	const bool bIsMeshVisible = MeshBounds.IsValid && !MeshBounds.GetExtent().IsNearlyZero();
+	if (bIsMeshVisible)
+	{
+		const FVector MeshExtent = MeshBounds.GetExtent().ComponentMax(FVector(KINDA_SMALL_NUMBER));
+		const FVector MeshScale = LocalBounds.GetExtent() / MeshExtent;
+
+		MeshComponent->SetStaticMesh(Mesh);
+		MeshComponent->SetRelativeScale3D(MeshScale);
+		MeshComponent->SetRelativeLocation(LocalBounds.GetCenter() - MeshBounds.GetCenter() * MeshScale);
+	}
+	MeshComponent->SetVisibility(bIsMeshVisible);
+	Box->SetVisibility(!bIsMeshVisible);
+
+	SetActorHiddenInGame(false);
+}
+
+void ATransformationActorsDragProxy::Release()
+{
+	Actor.Reset();
+	SetActorHiddenInGame(true);
+}
+
+int32 ATransformationActorsDragProxy::EstimateMoveCost(const AActor* InActor)
+{
+	if (InActor == nullptr)
+	{
+		return 0;
+	}
+
+	/*The attached actors are moved with the actor.*/
+	TArray<const AActor*> MovedActors;
+	MovedActors.Add(InActor);
+
+	int32 Cost = 0;
+	for (int32 ActorIndex = 0; ActorIndex < MovedActors.Num(); ++ActorIndex)
+	{
+		for (const UActorComponent* Component : MovedActors[ActorIndex]->GetComponents())
+		{
+			if (Component == nullptr || !Component->IsA<USceneComponent>())
+			{
+				continue;
+			}
+
+			if (Component->IsA<USkeletalMeshComponent>())
+			{
+				Cost += 8;
+			}
+			else if (Component->IsA<ULightComponent>())
+			{
+				Cost += 4;
+			}
+			else if (const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+			{
+				Cost += Primitive->GetGenerateOverlapEvents() ? 2 : 1;
+			}
+			else
+			{
+				Cost += 1;
+			}
+		}
+
+		TArray<AActor*> AttachedActors;
+		MovedActors[ActorIndex]->GetAttachedActors(AttachedActors);
+		for (const AActor* AttachedActor : AttachedActors)
+		{
+			MovedActors.AddUnique(AttachedActor);
+		}
+	}
+
+	return Cost;
+}
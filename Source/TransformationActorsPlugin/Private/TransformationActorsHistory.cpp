@@ -0,0 +1,459 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsHistory.h"
+#include "TransformationActorsStats.h"
+#include "GameFramework/Actor.h"
+
+namespace TransformationActorsHistory
+{
+	/*Translation is stored with the precision of 0.01 unit.*/
+	const float LocationPrecision = 100.f;
+
+	/*Scale is stored with the precision of 0.001.*/
+	const float ScalePrecision = 1000.f;
+
+	/*The three smallest components of a normalized quaternion are in [-1/sqrt(2), 1/sqrt(2)].*/
+	const float RotationPrecision = 32767.f * 1.41421356f;
+
+	const uint8 LargestComponentMask = 0x03;
+	const uint8 HasLocationFlag = 1 << 2;
+	const uint8 HasRotationFlag = 1 << 3;
+	const uint8 HasScaleFlag = 1 << 4;
+
+	const int32 DefaultMaxRecords = 65536;
+
+	/*Zigzag varint: the sign goes to the lowest bit, then 7 bits per byte, so the small deltas of both signs take one or two bytes.*/
+	void WriteVarInt(TArray<uint8>& Data, int32 Value)
+	{
+		uint32 ZigZag = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+		while (ZigZag >= 0x80)
+		{
+			Data.Add(static_cast<uint8>(ZigZag | 0x80));
+			ZigZag >>= 7;
+		}
+		Data.Add(static_cast<uint8>(ZigZag));
+	}
+
+	int32 ReadVarInt(const uint8*& Read)
+	{
+		uint32 ZigZag = 0;
+		for (int32 Shift = 0; ; Shift += 7)
+		{
+			const uint8 Byte = *Read++;
+			ZigZag |= static_cast<uint32>(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				break;
+			}
+		}
+		return static_cast<int32>(ZigZag >> 1) ^ -static_cast<int32>(ZigZag & 1);
+	}
+}
+
+FTransformationActorsHistory::FTransformationActorsHistory()
+	: RecordsOffset(0)
+	, DataOffset(0)
+	, FirstEntry(0)
+	, UndoEntries(0)
+	, MaxRecords(TransformationActorsHistory::DefaultMaxRecords)
+	, bIsTransactionOpen(false)
+{
+}
+
+void FTransformationActorsHistory::BeginTransaction(const TArray<AActor*>& Actors)
+{
+	TransactionActors.Reset(Actors.Num());
+	TransactionStartTransforms.Reset(Actors.Num());
+
+	for (AActor* Actor : Actors)
+	{
+		if (Actor)
+		{
+			TransactionActors.Add(Actor);
+			TransactionStartTransforms.Add(Actor->GetActorTransform());
+		}
+	}
+
+	bIsTransactionOpen = true;
+}
+
+bool FTransformationActorsHistory::CommitTransaction()
+{
+	TRANSFORMATIONACTORS_SCOPE(History);
+
+	if (!bIsTransactionOpen)
+	{
+		return false;
+	}
+	bIsTransactionOpen = false;
+
+	DropRedoEntries();
+
+	FEntry Entry;
+	Entry.FirstRecord = RecordsOffset + RecordActors.Num();
+	Entry.FirstByte = DataOffset + RecordData.Num();
+	Entry.NumRecords = 0;
+
+	FRecord Record;
+	for (int32 Index = 0; Index < TransactionActors.Num(); ++Index)
+	{
+		AActor* Actor = TransactionActors[Index].Get();
+		if (Actor && EncodeRecord(TransactionStartTransforms[Index], Actor->GetActorTransform(), Record))
+		{
+			RecordActors.Add(Actor);
+			PackRecord(Record, RecordData);
+			++Entry.NumRecords;
+		}
+	}
+
+	TransactionActors.Reset();
+	TransactionStartTransforms.Reset();
+
+	if (Entry.NumRecords == 0)
+	{
+		return false;
+	}
+
+	Entries.Add(Entry);
+	++UndoEntries;
+
+	DropOldEntries();
+
+	return true;
+}
+
+void FTransformationActorsHistory::CancelTransaction()
+{
+	bIsTransactionOpen = false;
+	TransactionActors.Reset();
+	TransactionStartTransforms.Reset();
+}
+
+bool FTransformationActorsHistory::Undo()
+{
+	TRANSFORMATIONACTORS_SCOPE(History);
+
+	if (!CanUndo() || bIsTransactionOpen)
+	{
+		return false;
+	}
+
+	/*The packed records are read forward and reverted backward.*/
+	const FEntry& Entry = Entries[FirstEntry + UndoEntries - 1];
+	TArray<FRecord> EntryRecords;
+	EntryRecords.SetNumUninitialized(Entry.NumRecords);
+
+	const uint8* Read = GetRecordData(Entry.FirstByte);
+	for (int32 Index = 0; Index < Entry.NumRecords; ++Index)
+	{
+		Read = UnpackRecord(Read, EntryRecords[Index]);
+	}
+
+	for (int32 Index = Entry.NumRecords - 1; Index >= 0; --Index)
+	{
+		ApplyRecord(GetRecordActor(Entry.FirstRecord + Index), EntryRecords[Index], false);
+	}
+
+	--UndoEntries;
+	return true;
+}
+
+bool FTransformationActorsHistory::Redo()
+{
+	TRANSFORMATIONACTORS_SCOPE(History);
+
+	if (!CanRedo() || bIsTransactionOpen)
+	{
+		return false;
+	}
+
+	const FEntry& Entry = Entries[FirstEntry + UndoEntries];
+	FRecord Record;
+	const uint8* Read = GetRecordData(Entry.FirstByte);
+	for (int32 Index = 0; Index < Entry.NumRecords; ++Index)
+	{
+		Read = UnpackRecord(Read, Record);
+		ApplyRecord(GetRecordActor(Entry.FirstRecord + Index), Record, true);
+	}
+
+	++UndoEntries;
+	return true;
+}
+
+void FTransformationActorsHistory::GetUndoActors(TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset();
+	if (CanUndo())
+	{
+		GetEntryActors(Entries[FirstEntry + UndoEntries - 1], OutActors);
+	}
+}
+
+void FTransformationActorsHistory::GetRedoActors(TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset();
+	if (CanRedo())
+	{
+		GetEntryActors(Entries[FirstEntry + UndoEntries], OutActors);
+	}
+}
+
+void FTransformationActorsHistory::GetEntryActors(const FEntry& Entry, TArray<AActor*>& OutActors) const
+{
+	OutActors.Reserve(OutActors.Num() + Entry.NumRecords);
+	for (int32 Index = 0; Index < Entry.NumRecords; ++Index)
+	{
+		if (AActor* Actor = GetRecordActor(Entry.FirstRecord + Index))
+		{
+			OutActors.Add(Actor);
+		}
+	}
+}
+
+void FTransformationActorsHistory::Empty()
+{
+	CancelTransaction();
+
+	RecordActors.Empty();
+	RecordData.Empty();
+	Entries.Empty();
+	RecordsOffset = 0;
+	DataOffset = 0;
+	FirstEntry = 0;
+	UndoEntries = 0;
+}
+
+void FTransformationActorsHistory::SetMaxRecords(int32 InMaxRecords)
+{
+	MaxRecords = FMath::Max(InMaxRecords, 1);
+
+	DropRedoEntries();
+	DropOldEntries();
+}
+
+SIZE_T FTransformationActorsHistory::GetAllocatedSize() const
+{
+	return RecordActors.GetAllocatedSize()
+		+ RecordData.GetAllocatedSize()
+		+ Entries.GetAllocatedSize()
+		+ TransactionActors.GetAllocatedSize()
+		+ TransactionStartTransforms.GetAllocatedSize();
+}
+
+bool FTransformationActorsHistory::EncodeRecord(const FTransform& StartTransform, const FTransform& EndTransform, FRecord& OutRecord)
+{
+	using namespace TransformationActorsHistory;
+
+	OutRecord.Flags = 0;
+
+	const FVector DeltaLocation = EndTransform.GetLocation() - StartTransform.GetLocation();
+	const FVector DeltaScale = EndTransform.GetScale3D() - StartTransform.GetScale3D();
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		OutRecord.DeltaLocation[Axis] = FMath::RoundToInt(DeltaLocation[Axis] * LocationPrecision);
+		OutRecord.DeltaScale[Axis] = FMath::RoundToInt(DeltaScale[Axis] * ScalePrecision);
+
+		if (OutRecord.DeltaLocation[Axis] != 0)
+		{
+			OutRecord.Flags |= HasLocationFlag;
+		}
+		if (OutRecord.DeltaScale[Axis] != 0)
+		{
+			OutRecord.Flags |= HasScaleFlag;
+		}
+	}
+
+	/*Rotation in world space: End = Delta * Start.*/
+	FQuat DeltaRotation = EndTransform.GetRotation() * StartTransform.GetRotation().Inverse();
+	DeltaRotation.Normalize();
+
+	float Components[4] = { DeltaRotation.X, DeltaRotation.Y, DeltaRotation.Z, DeltaRotation.W };
+
+	int32 LargestComponent = 0;
+	for (int32 Component = 1; Component < 4; ++Component)
+	{
+		if (FMath::Abs(Components[Component]) > FMath::Abs(Components[LargestComponent]))
+		{
+			LargestComponent = Component;
+		}
+	}
+
+	/*Q and -Q are the same rotation, the largest component is kept positive so that it can be restored from the others.*/
+	const float Sign = Components[LargestComponent] < 0.f ? -1.f : 1.f;
+
+	bool bIsRotationChanged = LargestComponent != 3;
+	int32 StoredComponent = 0;
+	for (int32 Component = 0; Component < 4; ++Component)
+	{
+		if (Component == LargestComponent)
+		{
+			continue;
+		}
+
+		const int32 Quantized = FMath::Clamp(FMath::RoundToInt(Components[Component] * Sign * RotationPrecision), -32767, 32767);
+		OutRecord.DeltaRotation[StoredComponent++] = static_cast<int16>(Quantized);
+		bIsRotationChanged |= Quantized != 0;
+	}
+
+	if (bIsRotationChanged)
+	{
+		OutRecord.Flags |= HasRotationFlag | static_cast<uint8>(LargestComponent);
+	}
+
+	return (OutRecord.Flags & (HasLocationFlag | HasRotationFlag | HasScaleFlag)) != 0;
+}
+
+void FTransformationActorsHistory::PackRecord(const FRecord& Record, TArray<uint8>& Data)
+{
+	using namespace TransformationActorsHistory;
+
+	Data.Add(Record.Flags);
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (Record.Flags & HasLocationFlag)
+		{
+			WriteVarInt(Data, Record.DeltaLocation[Axis]);
+		}
+	}
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (Record.Flags & HasRotationFlag)
+		{
+			WriteVarInt(Data, Record.DeltaRotation[Axis]);
+		}
+	}
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (Record.Flags & HasScaleFlag)
+		{
+			WriteVarInt(Data, Record.DeltaScale[Axis]);
+		}
+	}
+}
+
+const uint8* FTransformationActorsHistory::UnpackRecord(const uint8* Read, FRecord& OutRecord)
+{
+	using namespace TransformationActorsHistory;
+
+	OutRecord.Flags = *Read++;
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		OutRecord.DeltaLocation[Axis] = (OutRecord.Flags & HasLocationFlag) ? ReadVarInt(Read) : 0;
+	}
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		OutRecord.DeltaRotation[Axis] = (OutRecord.Flags & HasRotationFlag) ? static_cast<int16>(ReadVarInt(Read)) : 0;
+	}
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		OutRecord.DeltaScale[Axis] = (OutRecord.Flags & HasScaleFlag) ? ReadVarInt(Read) : 0;
+	}
+
+	return Read;
+}
+
+void FTransformationActorsHistory::ApplyRecord(AActor* Actor, const FRecord& Record, bool bIsForward)
+{
+	using namespace TransformationActorsHistory;
+
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	const float Direction = bIsForward ? 1.f : -1.f;
+	FTransform Transform = Actor->GetActorTransform();
+
+	if (Record.Flags & HasLocationFlag)
+	{
+		const FVector DeltaLocation(Record.DeltaLocation[0], Record.DeltaLocation[1], Record.DeltaLocation[2]);
+		Transform.AddToTranslation(DeltaLocation * (Direction / LocationPrecision));
+	}
+
+	if (Record.Flags & HasRotationFlag)
+	{
+		const int32 LargestComponent = Record.Flags & LargestComponentMask;
+
+		float Components[4];
+		float SumSquared = 0.f;
+		int32 StoredComponent = 0;
+		for (int32 Component = 0; Component < 4; ++Component)
+		{
+			if (Component == LargestComponent)
+			{
+				continue;
+			}
+
+			Components[Component] = Record.DeltaRotation[StoredComponent++] / RotationPrecision;
+			SumSquared += FMath::Square(Components[Component]);
+		}
+		Components[LargestComponent] = FMath::Sqrt(FMath::Max(0.f, 1.f - SumSquared));
+
+		FQuat DeltaRotation(Components[0], Components[1], Components[2], Components[3]);
+		if (!bIsForward)
+		{
+			DeltaRotation = DeltaRotation.Inverse();
+		}
+
+		FQuat NewRotation = DeltaRotation * Transform.GetRotation();
+		NewRotation.Normalize();
+		Transform.SetRotation(NewRotation);
+	}
+
+	if (Record.Flags & HasScaleFlag)
+	{
+		const FVector DeltaScale(Record.DeltaScale[0], Record.DeltaScale[1], Record.DeltaScale[2]);
+		Transform.SetScale3D(Transform.GetScale3D() + DeltaScale * (Direction / ScalePrecision));
+	}
+
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+void FTransformationActorsHistory::DropRedoEntries()
+{
+	const int32 NumEntries = FirstEntry + UndoEntries;
+	if (NumEntries == Entries.Num())
+	{
+		return;
+	}
+
+	const int64 EndRecord = Entries[NumEntries].FirstRecord;
+	const int64 EndByte = Entries[NumEntries].FirstByte;
+	Entries.SetNum(NumEntries, false);
+	RecordActors.SetNum(static_cast<int32>(EndRecord - RecordsOffset), false);
+	RecordData.SetNum(static_cast<int32>(EndByte - DataOffset), false);
+}
+
+void FTransformationActorsHistory::DropOldEntries()
+{
+	const int64 EndRecord = RecordsOffset + RecordActors.Num();
+
+	/*The newest entry is kept even if it alone exceeds the limit.*/
+	while (UndoEntries > 1 && EndRecord - Entries[FirstEntry].FirstRecord > MaxRecords)
+	{
+		++FirstEntry;
+		--UndoEntries;
+	}
+
+	/*Remove the dropped entries and records from the arrays when they take at least half of them.*/
+	if (FirstEntry > 0 && FirstEntry * 2 >= Entries.Num())
+	{
+		Entries.RemoveAt(0, FirstEntry, false);
+		FirstEntry = 0;
+	}
+
+	const int64 LiveRecord = FirstEntry < Entries.Num() ? Entries[FirstEntry].FirstRecord : EndRecord;
+	const int64 LiveByte = FirstEntry < Entries.Num() ? Entries[FirstEntry].FirstByte : DataOffset + RecordData.Num();
+	const int32 NumDroppedRecords = static_cast<int32>(LiveRecord - RecordsOffset);
+	if (NumDroppedRecords > 0 && NumDroppedRecords * 2 >= RecordActors.Num())
+	{
+		RecordActors.RemoveAt(0, NumDroppedRecords, false);
+		RecordData.RemoveAt(0, static_cast<int32>(LiveByte - DataOffset), false);
+		RecordsOffset = LiveRecord;
+		DataOffset = LiveByte;
+	}
+}
@@ -0,0 +1,65 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsInstanceProxy.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+ATransformationActorsInstanceProxy::ATransformationActorsInstanceProxy()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	Root->SetMobility(EComponentMobility::Movable);
+	RootComponent = Root;
+
+	bIsWritePending = false;
+	InstanceIndex = INDEX_NONE;
+}
+
+bool ATransformationActorsInstanceProxy::SetInstance(UInstancedStaticMeshComponent* InInstanceComponent, int32 InInstanceIndex)
+{
+	FTransform InstanceTransform;
+	if (InInstanceComponent == nullptr || !InInstanceComponent->GetInstanceTransform(InInstanceIndex, InstanceTransform, true))
+	{
+		return false;
+	}
+
+	/*The moves are reported only after the proxy is at the instance.*/
+	Root->TransformUpdated.RemoveAll(this);
+	SetActorTransform(InstanceTransform, false, nullptr, ETeleportType::TeleportPhysics);
+	Root->TransformUpdated.AddUObject(this, &ATransformationActorsInstanceProxy::OnRootTransformUpdated);
+
+	InstanceComponent = InInstanceComponent;
+	InstanceIndex = InInstanceIndex;
+
+	return true;
+}
+
+AActor* ATransformationActorsInstanceProxy::GetInstanceOwner() const
+{
+	const UInstancedStaticMeshComponent* Component = InstanceComponent.Get();
+	return Component ? Component->GetOwner() : nullptr;
+}
+
+bool ATransformationActorsInstanceProxy::IsInstance(const UInstancedStaticMeshComponent* InInstanceComponent, int32 InInstanceIndex) const
+{
+	return InstanceIndex == InInstanceIndex && InstanceComponent.Get() == InInstanceComponent;
+}
+
+bool ATransformationActorsInstanceProxy::WriteInstanceTransform() const
+{
+	UInstancedStaticMeshComponent* Component = InstanceComponent.Get();
+
+	/*The indices of the instances are shifted when the instances are removed, the proxy of a removed index is skipped.*/
+	if (Component == nullptr || !Component->IsValidInstance(InstanceIndex))
+	{
+		return false;
+	}
+
+	return Component->UpdateInstanceTransform(InstanceIndex, GetActorTransform(), true, false, true);
+}
+
+void ATransformationActorsInstanceProxy::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	OnMoved.ExecuteIfBound(this);
+}
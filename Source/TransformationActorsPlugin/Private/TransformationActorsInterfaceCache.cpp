@@ -0,0 +1,118 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsInterfaceCache.h"
+#include "TransformationActorsInterface.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/Class.h"
+#if WITH_HOT_RELOAD
+#include "Misc/HotReloadInterface.h"
+#endif
+
+TMap<const UClass*, ETransformationActorsInterfaceCaps> FTransformationActorsInterfaceCache::CapsByClass;
+FDelegateHandle FTransformationActorsInterfaceCache::PostGarbageCollectHandle;
+FDelegateHandle FTransformationActorsInterfaceCache::HotReloadHandle;
+
+namespace TransformationActorsInterfaceCache
+{
+	/*The event is implemented if the function found in the class is not the declaration of the interface itself.*/
+	bool IsEventImplemented(const UClass* Class, FName EventName)
+	{
+		const UFunction* Function = Class->FindFunctionByName(EventName);
+		return Function && Function->GetOuter() != UTransformationActorsInterface::StaticClass();
+	}
+}
+
+ETransformationActorsInterfaceCaps FTransformationActorsInterfaceCache::GetCaps(const UClass* Class)
+{
+	check(IsInGameThread());
+
+	if (Class == nullptr)
+	{
+		return ETransformationActorsInterfaceCaps::None;
+	}
+
+	if (const ETransformationActorsInterfaceCaps* Caps = CapsByClass.Find(Class))
+	{
+		return *Caps;
+	}
+
+	return CapsByClass.Add(Class, BuildCaps(Class));
+}
+
+bool FTransformationActorsInterfaceCache::Implements(const UObject* Object)
+{
+	return Object && EnumHasAnyFlags(GetCaps(Object->GetClass()), ETransformationActorsInterfaceCaps::Implements);
+}
+
+bool FTransformationActorsInterfaceCache::HasEvent(const UObject* Object, ETransformationActorsInterfaceCaps Event)
+{
+	return Object && EnumHasAllFlags(GetCaps(Object->GetClass()), Event | ETransformationActorsInterfaceCaps::Implements);
+}
+
+void FTransformationActorsInterfaceCache::Invalidate()
+{
+	CapsByClass.Reset();
+}
+
+void FTransformationActorsInterfaceCache::Startup()
+{
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&FTransformationActorsInterfaceCache::Invalidate);
+
+#if WITH_HOT_RELOAD
+	if (IHotReloadInterface* HotReload = IHotReloadInterface::GetPtr())
+	{
+		HotReloadHandle = HotReload->OnHotReload().AddLambda([](bool /*bWasTriggeredAutomatically*/)
+		{
+			FTransformationActorsInterfaceCache::Invalidate();
+		});
+	}
+#endif
+}
+
+void FTransformationActorsInterfaceCache::Shutdown()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PostGarbageCollectHandle.Reset();
+
+#if WITH_HOT_RELOAD
+	if (IHotReloadInterface* HotReload = IHotReloadInterface::GetPtr())
+	{
+		HotReload->OnHotReload().Remove(HotReloadHandle);
+	}
+	HotReloadHandle.Reset();
+#endif
+
+	Invalidate();
+}
+
+ETransformationActorsInterfaceCaps FTransformationActorsInterfaceCache::BuildCaps(const UClass* Class)
+{
+	ETransformationActorsInterfaceCaps Caps = ETransformationActorsInterfaceCaps::None;
+
+	if (!Class->ImplementsInterface(UTransformationActorsInterface::StaticClass()))
+	{
+		return Caps;
+	}
+
+	Caps |= ETransformationActorsInterfaceCaps::Implements;
+
+	if (TransformationActorsInterfaceCache::IsEventImplemented(Class, GET_FUNCTION_NAME_CHECKED(ITransformationActorsInterface, HighlightOn)))
+	{
+		Caps |= ETransformationActorsInterfaceCaps::HighlightOn;
+	}
+	if (TransformationActorsInterfaceCache::IsEventImplemented(Class, GET_FUNCTION_NAME_CHECKED(ITransformationActorsInterface, HighlightOff)))
+	{
+		Caps |= ETransformationActorsInterfaceCaps::HighlightOff;
+	}
+	if (TransformationActorsInterfaceCache::IsEventImplemented(Class, GET_FUNCTION_NAME_CHECKED(ITransformationActorsInterface, StartTransformation)))
+	{
+		Caps |= ETransformationActorsInterfaceCaps::StartTransformation;
+	}
+	if (TransformationActorsInterfaceCache::IsEventImplemented(Class, GET_FUNCTION_NAME_CHECKED(ITransformationActorsInterface, StopTransformation)))
+	{
+		Caps |= ETransformationActorsInterfaceCaps::StopTransformation;
+	}
+
+	return Caps;
+}
@@ -0,0 +1,158 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsMovement.h"
+#include "TransformationActorsStats.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Components/PrimitiveComponent.h"
+
+FTransformationActorsMovementBatch::FTransformationActorsMovementBatch()
+{
+}
+
+FTransformationActorsMovementBatch::~FTransformationActorsMovementBatch()
+{
+	Close();
+}
+
+void FTransformationActorsMovementBatch::Add(AActor* Actor)
+{
+	if (Actor == nullptr || Actor->GetRootComponent() == nullptr)
+	{
+		return;
+	}
+
+	Scopes.Add(MakeUnique<FScopedMovementUpdate>(Actor->GetRootComponent(), EScopedUpdate::DeferredUpdates));
+}
+
+void FTransformationActorsMovementBatch::Close()
+{
+	if (Scopes.Num() == 0)
+	{
+		return;
+	}
+
+	TRANSFORMATIONACTORS_SCOPE(MovementUpdate);
+
+	/*The children of an actor attached to another moved actor are updated by the scope of the parent, which is closed later.*/
+	for (int32 Index = Scopes.Num() - 1; Index >= 0; --Index)
+	{
+		Scopes[Index].Reset();
+	}
+	Scopes.Reset();
+}
+
+FTransformationActorsOverlapDeferral::FTransformationActorsOverlapDeferral()
+	: PauseTime(0.f)
+{
+}
+
+void FTransformationActorsOverlapDeferral::Pause(const TArray<AActor*>& Actors, float CurrentTime)
+{
+	PauseTime = CurrentTime;
+
+	/*The attached actors are moved with the actors.*/
+	TArray<AActor*> MovedActors;
+	for (AActor* Actor : Actors)
+	{
+		if (Actor)
+		{
+			MovedActors.AddUnique(Actor);
+		}
+	}
+	for (int32 ActorIndex = 0; ActorIndex < MovedActors.Num(); ++ActorIndex)
+	{
+		TArray<AActor*> AttachedActors;
+		MovedActors[ActorIndex]->GetAttachedActors(AttachedActors);
+		for (AActor* AttachedActor : AttachedActors)
+		{
+			MovedActors.AddUnique(AttachedActor);
+		}
+	}
+
+	for (AActor* Actor : MovedActors)
+	{
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			USceneComponent* SceneComponent = Cast<USceneComponent>(Component);
+			if (SceneComponent && SceneComponent->bShouldUpdatePhysicsVolume)
+			{
+				SceneComponent->SetShouldUpdatePhysicsVolume(false);
+				PausedVolumeComponents.Add(SceneComponent);
+			}
+
+			UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+			if (Primitive == nullptr || !Primitive->GetGenerateOverlapEvents())
+			{
+				continue;
+			}
+
+			FPausedPrimitive& PausedPrimitive = PausedPrimitives[PausedPrimitives.AddDefaulted()];
+			PausedPrimitive.Component = Primitive;
+			PausedPrimitive.Overlaps = Primitive->GetOverlapInfos();
+
+			Primitive->SetGenerateOverlapEvents(false);
+			for (const FOverlapInfo& Overlap : PausedPrimitive.Overlaps)
+			{
+				Primitive->EndComponentOverlap(Overlap, false);
+			}
+		}
+	}
+}
+
+void FTransformationActorsOverlapDeferral::Resume()
+{
+	if (!IsPaused())
+	{
+		return;
+	}
+
+	TRANSFORMATIONACTORS_SCOPE(MovementUpdate);
+
+	/*All primitives generate the overlaps again before any overlap is restored, so the overlaps between the paused actors are restored too.*/
+	for (const FPausedPrimitive& PausedPrimitive : PausedPrimitives)
+	{
+		if (PausedPrimitive.Component.IsValid())
+		{
+			PausedPrimitive.Component->SetGenerateOverlapEvents(true);
+		}
+	}
+
+	for (const FPausedPrimitive& PausedPrimitive : PausedPrimitives)
+	{
+		UPrimitiveComponent* Primitive = PausedPrimitive.Component.Get();
+		if (Primitive == nullptr)
+		{
+			continue;
+		}
+
+		for (const FOverlapInfo& Overlap : PausedPrimitive.Overlaps)
+		{
+			if (Overlap.OverlapInfo.Component.IsValid())
+			{
+				Primitive->BeginComponentOverlap(Overlap, false);
+			}
+		}
+	}
+
+	for (const FPausedPrimitive& PausedPrimitive : PausedPrimitives)
+	{
+		if (PausedPrimitive.Component.IsValid())
+		{
+			PausedPrimitive.Component->UpdateOverlaps();
+		}
+	}
+
+	for (const TWeakObjectPtr<USceneComponent>& SceneComponent : PausedVolumeComponents)
+	{
+		if (SceneComponent.IsValid())
+		{
+			SceneComponent->SetShouldUpdatePhysicsVolume(true);
+			SceneComponent->UpdatePhysicsVolume(true);
+		}
+	}
+
+	PausedPrimitives.Reset();
+	PausedVolumeComponents.Reset();
+}
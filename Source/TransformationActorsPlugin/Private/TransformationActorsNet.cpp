@@ -0,0 +1,317 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsNet.h"
+#include "TransformationActorsStats.h"
+#include "GameFramework/Actor.h"
+
+namespace TransformationActorsNet
+{
+	/*Precision of the quantized values. Must match the types of the net structs.*/
+	const float DeltaLocationPrecision = 10.f;
+	const float LocationPrecision = 100.f;
+	const float ScalePrecision = 100.f;
+
+	/*Actors that differ from the prediction more than this are corrected at the end of the session.*/
+	const float CorrectionLocationTolerance = 1.f;
+	const float CorrectionRotationTolerance = 0.01f;
+	const float CorrectionScaleTolerance = 0.01f;
+
+	/*The interpolation is finished when the remaining difference is below this.*/
+	const float InterpolationTolerance = 0.01f;
+
+	FVector RoundVector(const FVector& Vector, float Precision)
+	{
+		return FVector(
+			FMath::RoundToFloat(Vector.X * Precision) / Precision,
+			FMath::RoundToFloat(Vector.Y * Precision) / Precision,
+			FMath::RoundToFloat(Vector.Z * Precision) / Precision);
+	}
+
+	/*The values received from the network are checked against the size of the world.*/
+	bool IsValidVector(const FVector& Vector)
+	{
+		return !Vector.ContainsNaN() && Vector.GetAbsMax() <= WORLD_MAX;
+	}
+
+	FRotator DecompressRotator(uint16 Pitch, uint16 Yaw, uint16 Roll)
+	{
+		return FRotator(
+			FRotator::DecompressAxisFromShort(Pitch),
+			FRotator::DecompressAxisFromShort(Yaw),
+			FRotator::DecompressAxisFromShort(Roll));
+	}
+}
+
+FTransformationActorsNetDelta::FTransformationActorsNetDelta()
+	: Location(FVector::ZeroVector)
+	, Pitch(0)
+	, Yaw(0)
+	, Roll(0)
+	, ScaleRatio(FVector::OneVector)
+{
+}
+
+FTransformationActorsNetDelta FTransformationActorsNetDelta::Make(const FTransform& StartTransform, const FTransform& CurrentTransform)
+{
+	using namespace TransformationActorsNet;
+
+	FTransformationActorsNetDelta Delta;
+
+	/*The values are rounded here as well, so the sender gets the same result as the receivers.*/
+	Delta.Location = RoundVector(CurrentTransform.GetLocation() - StartTransform.GetLocation(), DeltaLocationPrecision);
+
+	FQuat DeltaRotation = CurrentTransform.GetRotation() * StartTransform.GetRotation().Inverse();
+	DeltaRotation.Normalize();
+	const FRotator DeltaRotator = DeltaRotation.Rotator();
+	Delta.Pitch = FRotator::CompressAxisToShort(DeltaRotator.Pitch);
+	Delta.Yaw = FRotator::CompressAxisToShort(DeltaRotator.Yaw);
+	Delta.Roll = FRotator::CompressAxisToShort(DeltaRotator.Roll);
+
+	const FVector StartScale3D = StartTransform.GetScale3D();
+	const FVector CurrentScale3D = CurrentTransform.GetScale3D();
+	const FVector Ratio(
+		StartScale3D.X != 0.f ? CurrentScale3D.X / StartScale3D.X : 1.f,
+		StartScale3D.Y != 0.f ? CurrentScale3D.Y / StartScale3D.Y : 1.f,
+		StartScale3D.Z != 0.f ? CurrentScale3D.Z / StartScale3D.Z : 1.f);
+	Delta.ScaleRatio = RoundVector(Ratio, ScalePrecision);
+
+	return Delta;
+}
+
+FQuat FTransformationActorsNetDelta::GetRotation() const
+{
+	return TransformationActorsNet::DecompressRotator(Pitch, Yaw, Roll).Quaternion();
+}
+
+bool FTransformationActorsNetDelta::IsValid() const
+{
+	return TransformationActorsNet::IsValidVector(Location) && TransformationActorsNet::IsValidVector(ScaleRatio);
+}
+
+FTransformationActorsNetTransform::FTransformationActorsNetTransform()
+	: Actor(nullptr)
+	, Location(FVector::ZeroVector)
+	, Pitch(0)
+	, Yaw(0)
+	, Roll(0)
+	, Scale(FVector::OneVector)
+{
+}
+
+FTransformationActorsNetTransform FTransformationActorsNetTransform::Make(AActor* InActor, const FTransform& Transform)
+{
+	using namespace TransformationActorsNet;
+
+	FTransformationActorsNetTransform NetTransform;
+	NetTransform.Actor = InActor;
+	NetTransform.Location = RoundVector(Transform.GetLocation(), LocationPrecision);
+
+	const FRotator Rotator = Transform.Rotator();
+	NetTransform.Pitch = FRotator::CompressAxisToShort(Rotator.Pitch);
+	NetTransform.Yaw = FRotator::CompressAxisToShort(Rotator.Yaw);
+	NetTransform.Roll = FRotator::CompressAxisToShort(Rotator.Roll);
+
+	NetTransform.Scale = RoundVector(Transform.GetScale3D(), ScalePrecision);
+
+	return NetTransform;
+}
+
+FTransform FTransformationActorsNetTransform::GetTransform() const
+{
+	return FTransform(TransformationActorsNet::DecompressRotator(Pitch, Yaw, Roll), Location, Scale);
+}
+
+bool FTransformationActorsNetTransform::IsValid() const
+{
+	return TransformationActorsNet::IsValidVector(Location) && TransformationActorsNet::IsValidVector(Scale);
+}
+
+FTransformationActorsNetSession::FTransformationActorsNetSession()
+	: bIsActive(false)
+	, PivotStartTransform(FTransform::Identity)
+	, CurrentLocation(FVector::ZeroVector)
+	, CurrentRotation(FQuat::Identity)
+	, CurrentScaleRatio(FVector::OneVector)
+	, TargetLocation(FVector::ZeroVector)
+	, TargetRotation(FQuat::Identity)
+	, TargetScaleRatio(FVector::OneVector)
+	, bHasTarget(false)
+{
+}
+
+void FTransformationActorsNetSession::Begin(const TArray<AActor*>& InActors, AActor* PivotActor)
+{
+	Actors.Reset(InActors.Num());
+	StartTransforms.Reset(InActors.Num());
+
+	for (AActor* Actor : InActors)
+	{
+		if (Actor)
+		{
+			Actors.Add(Actor);
+			StartTransforms.Add(Actor->GetActorTransform());
+		}
+	}
+
+	if (PivotActor)
+	{
+		PivotStartTransform = PivotActor->GetActorTransform();
+	}
+	else
+	{
+		PivotStartTransform = StartTransforms.Num() > 0 ? StartTransforms[0] : FTransform::Identity;
+	}
+
+	CurrentLocation = FVector::ZeroVector;
+	CurrentRotation = FQuat::Identity;
+	CurrentScaleRatio = FVector::OneVector;
+	bHasTarget = false;
+	bIsActive = true;
+}
+
+void FTransformationActorsNetSession::End()
+{
+	Actors.Reset();
+	StartTransforms.Reset();
+	bHasTarget = false;
+	bIsActive = false;
+}
+
+void FTransformationActorsNetSession::Apply(const FTransformationActorsNetDelta& Delta)
+{
+	TRANSFORMATIONACTORS_SCOPE(NetSession);
+
+	if (!bIsActive)
+	{
+		return;
+	}
+
+	CurrentLocation = Delta.Location;
+	CurrentRotation = Delta.GetRotation();
+	CurrentScaleRatio = Delta.ScaleRatio;
+	bHasTarget = false;
+
+	ApplyDecoded(CurrentLocation, CurrentRotation, CurrentScaleRatio);
+}
+
+void FTransformationActorsNetSession::SetTarget(const FTransformationActorsNetDelta& Delta)
+{
+	if (!bIsActive)
+	{
+		return;
+	}
+
+	TargetLocation = Delta.Location;
+	TargetRotation = Delta.GetRotation();
+	TargetScaleRatio = Delta.ScaleRatio;
+	bHasTarget = true;
+}
+
+bool FTransformationActorsNetSession::Interpolate(float DeltaTime, float InterpolationSpeed)
+{
+	TRANSFORMATIONACTORS_SCOPE(NetSession);
+
+	using namespace TransformationActorsNet;
+
+	if (!bIsActive || !bHasTarget)
+	{
+		return false;
+	}
+
+	/*The same exponential approach as FMath::VInterpTo, applied to all parts of the delta.*/
+	const float Alpha = InterpolationSpeed > 0.f ? FMath::Clamp(DeltaTime * InterpolationSpeed, 0.f, 1.f) : 1.f;
+
+	CurrentLocation = FMath::Lerp(CurrentLocation, TargetLocation, Alpha);
+	CurrentRotation = FQuat::Slerp(CurrentRotation, TargetRotation, Alpha);
+	CurrentScaleRatio = FMath::Lerp(CurrentScaleRatio, TargetScaleRatio, Alpha);
+
+	if (CurrentLocation.Equals(TargetLocation, InterpolationTolerance)
+		&& CurrentRotation.Equals(TargetRotation, KINDA_SMALL_NUMBER)
+		&& CurrentScaleRatio.Equals(TargetScaleRatio, KINDA_SMALL_NUMBER))
+	{
+		CurrentLocation = TargetLocation;
+		CurrentRotation = TargetRotation;
+		CurrentScaleRatio = TargetScaleRatio;
+		bHasTarget = false;
+	}
+
+	ApplyDecoded(CurrentLocation, CurrentRotation, CurrentScaleRatio);
+
+	return bHasTarget;
+}
+
+void FTransformationActorsNetSession::MakeCorrections(const FTransformationActorsNetDelta& Delta, TArray<FTransformationActorsNetTransform>& OutCorrections) const
+{
+	using namespace TransformationActorsNet;
+
+	OutCorrections.Reset();
+
+	const FQuat DeltaRotation = Delta.GetRotation();
+
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		AActor* Actor = Actors[Index].Get();
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		const FTransform Predicted = PredictTransform(Index, Delta.Location, DeltaRotation, Delta.ScaleRatio);
+		const FTransform Actual = Actor->GetActorTransform();
+
+		if (!Predicted.GetLocation().Equals(Actual.GetLocation(), CorrectionLocationTolerance)
+			|| !Predicted.GetRotation().Equals(Actual.GetRotation(), CorrectionRotationTolerance)
+			|| !Predicted.GetScale3D().Equals(Actual.GetScale3D(), CorrectionScaleTolerance))
+		{
+			OutCorrections.Add(FTransformationActorsNetTransform::Make(Actor, Actual));
+		}
+	}
+}
+
+void FTransformationActorsNetSession::PredictTransforms(const FTransformationActorsNetDelta& Delta, TArray<FTransform>& OutTransforms) const
+{
+	const FQuat DeltaRotation = Delta.GetRotation();
+
+	OutTransforms.Reset(Actors.Num());
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		OutTransforms.Add(PredictTransform(Index, Delta.Location, DeltaRotation, Delta.ScaleRatio));
+	}
+}
+
+void FTransformationActorsNetSession::ApplyCorrections(const TArray<FTransformationActorsNetTransform>& Corrections)
+{
+	for (const FTransformationActorsNetTransform& Correction : Corrections)
+	{
+		if (Correction.Actor)
+		{
+			Correction.Actor->SetActorTransform(Correction.GetTransform(), false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+}
+
+FTransform FTransformationActorsNetSession::PredictTransform(int32 Index, const FVector& DeltaLocation, const FQuat& DeltaRotation, const FVector& ScaleRatio) const
+{
+	const FTransform& StartTransform = StartTransforms[Index];
+	const FVector Pivot = PivotStartTransform.GetLocation();
+
+	/*The group is rotated around the controlled actor and moved with it, the scale of each actor is multiplied by the ratio.*/
+	const FVector NewLocation = Pivot + DeltaRotation.RotateVector(StartTransform.GetLocation() - Pivot) + DeltaLocation;
+	FQuat NewRotation = DeltaRotation * StartTransform.GetRotation();
+	NewRotation.Normalize();
+
+	return FTransform(NewRotation, NewLocation, StartTransform.GetScale3D() * ScaleRatio);
+}
+
+void FTransformationActorsNetSession::ApplyDecoded(const FVector& DeltaLocation, const FQuat& DeltaRotation, const FVector& ScaleRatio)
+{
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		AActor* Actor = Actors[Index].Get();
+		if (Actor)
+		{
+			Actor->SetActorTransform(PredictTransform(Index, DeltaLocation, DeltaRotation, ScaleRatio), false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+}
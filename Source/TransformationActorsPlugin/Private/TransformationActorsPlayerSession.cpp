@@ -0,0 +1,56 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsPlayerSession.h"
+#include "TransformationActorsComponent.h"
+
+FTransformationActorsPlayerSession::FTransformationActorsPlayerSession()
+	: TransformState(ETransformState::ETS_Idle)
+	, bIsTransform(false)
+	, bIsLocationTickActive(false)
+	, bIsRotationTickActive(false)
+	, bIsScaleTickActive(false)
+	, bIsLockFirstIterationLocationTimer(false)
+	, bIsLockFirstIterationRotationTimer(false)
+	, bIsLockFirstIterationScaleTimer(false)
+	, RawMouseCursor(FVector2D::ZeroVector)
+	, bUseVirtualCursor(false)
+	, VirtualCursor(FVector2D::ZeroVector)
+	, bUseCursorRay(false)
+	, CursorRayOrigin(FVector::ZeroVector)
+	, CursorRayDirection(FVector::ForwardVector)
+	, bIsMarqueeSelection(false)
+	, MarqueeStart(FVector2D::ZeroVector)
+	, bIsCursorPickPending(false)
+	, bIsStopRequestedDuringPick(false)
+	, PendingKeyboardLocation(FVector::ZeroVector)
+	, PendingKeyboardRotation(FVector::ZeroVector)
+	, PendingKeyboardScale3D(FVector::ZeroVector)
+	, bIsKeyboardCommitPending(false)
+	, SnapRawTransform(FTransform::Identity)
+	, SnapAppliedTransform(FTransform::Identity)
+	, LastLocationUpdateTime(0.f)
+	, RollSave(0.f)
+	, PitchSave(0.f)
+	, YawSave(0.f)
+	, DeltaRollDegree(0.f)
+	, DeltaPitchDegree(0.f)
+	, DeltaYawDegree(0.f)
+	, DistanceToCursorSave(0.f)
+	, LocationXAtClick(0.f)
+	, LocationYAtClick(0.f)
+	, Scale3DSave(FVector::OneVector)
+	, NewScale3D(FVector::OneVector)
+	, SumInputAxisValue(0.f)
+	, bIsLocationLeftRightKeyboard(false)
+	, bIsLocationUpDownKeyboard(false)
+	, bIsLocationInsideOutsideKeyboard(false)
+	, bIsRotationRollKeyboard(false)
+	, bIsRotationPitchKeyboard(false)
+	, bIsRotationYawKeyboard(false)
+	, bIsScaleKeyboard(false)
+	, bIsScaleXKeyboard(false)
+	, bIsScaleYKeyboard(false)
+	, bIsScaleZKeyboard(false)
+{
+}
@@ -0,0 +1,71 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsRawMouseInput.h"
+#include "Framework/Application/SlateApplication.h"
+
+FTransformationActorsRawMouseInput::FTransformationActorsRawMouseInput(TFunction<void()> InOnFirstDelta)
+	: PendingDelta(FVector2D::ZeroVector)
+	, bHasPendingDelta(false)
+	, bIsRegistered(false)
+	, OnFirstDelta(MoveTemp(InOnFirstDelta))
+{
+}
+
+bool FTransformationActorsRawMouseInput::Register()
+{
+	if (bIsRegistered)
+	{
+		return true;
+	}
+
+	if (!FSlateApplication::IsInitialized())
+	{
+		return false;
+	}
+
+	PendingDelta = FVector2D::ZeroVector;
+	bHasPendingDelta = false;
+	bIsRegistered = FSlateApplication::Get().RegisterInputPreProcessor(AsShared());
+
+	return bIsRegistered;
+}
+
+void FTransformationActorsRawMouseInput::Unregister()
+{
+	if (bIsRegistered && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(AsShared());
+	}
+	bIsRegistered = false;
+}
+
+FVector2D FTransformationActorsRawMouseInput::ConsumeDelta()
+{
+	const FVector2D Delta = PendingDelta;
+	PendingDelta = FVector2D::ZeroVector;
+	bHasPendingDelta = false;
+	return Delta;
+}
+
+bool FTransformationActorsRawMouseInput::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	const FVector2D Delta = MouseEvent.GetCursorDelta();
+	if (Delta.IsZero())
+	{
+		return false;
+	}
+
+	PendingDelta += Delta;
+
+	if (!bHasPendingDelta)
+	{
+		bHasPendingDelta = true;
+		if (OnFirstDelta)
+		{
+			OnFirstDelta();
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,276 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsSelection.h"
+#include "TransformationActorsStats.h"
+#include "GameFramework/Actor.h"
+
+namespace TransformationActorsSelection
+{
+	void WriteVector(const TransformationActorsMath::FVectorStreams& Streams, int32 Index, const FVector& Vector)
+	{
+		Streams.X[Index] = Vector.X;
+		Streams.Y[Index] = Vector.Y;
+		Streams.Z[Index] = Vector.Z;
+	}
+
+	FVector ReadVector(const TransformationActorsMath::FVectorStreams& Streams, int32 Index)
+	{
+		return FVector(Streams.X[Index], Streams.Y[Index], Streams.Z[Index]);
+	}
+
+	void WriteQuat(const TransformationActorsMath::FQuatStreams& Streams, int32 Index, const FQuat& Quat)
+	{
+		Streams.X[Index] = Quat.X;
+		Streams.Y[Index] = Quat.Y;
+		Streams.Z[Index] = Quat.Z;
+		Streams.W[Index] = Quat.W;
+	}
+
+	FQuat ReadQuat(const TransformationActorsMath::FQuatStreams& Streams, int32 Index)
+	{
+		return FQuat(Streams.X[Index], Streams.Y[Index], Streams.Z[Index], Streams.W[Index]);
+	}
+}
+
+bool FTransformationActorsSelection::Add(AActor* Actor)
+{
+	if (Actor == nullptr || Contains(Actor))
+	{
+		return false;
+	}
+
+	const int32 Index = Actors.Add(Actor);
+	StartTransforms.Add(Actor->GetActorTransform());
+	IndexByActor.Add(Actor, Index);
+
+	return true;
+}
+
+bool FTransformationActorsSelection::Remove(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+	if (!IndexByActor.RemoveAndCopyValue(TWeakObjectPtr<AActor>(Actor), Index))
+	{
+		return false;
+	}
+
+	/*The last actor takes the place of the removed one.*/
+	Actors.RemoveAtSwap(Index, 1, false);
+	StartTransforms.RemoveAtSwap(Index, 1, false);
+
+	if (Actors.IsValidIndex(Index))
+	{
+		IndexByActor.Add(Actors[Index], Index);
+	}
+
+	return true;
+}
+
+void FTransformationActorsSelection::Empty()
+{
+	Actors.Reset();
+	StartTransforms.Reset();
+	IndexByActor.Reset();
+}
+
+void FTransformationActorsSelection::GetActors(TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset(Actors.Num());
+	for (const TWeakObjectPtr<AActor>& Actor : Actors)
+	{
+		if (Actor.IsValid())
+		{
+			OutActors.Add(Actor.Get());
+		}
+	}
+}
+
+void FTransformationActorsSelection::CaptureTransforms()
+{
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		const AActor* Actor = Actors[Index].Get();
+		if (Actor)
+		{
+			StartTransforms[Index] = Actor->GetActorTransform();
+		}
+	}
+}
+
+void FTransformationActorsSelection::ApplyDeltaLocation(const FVector& DeltaLocation, bool bSweep, const AActor* SkipActor)
+{
+	TRANSFORMATIONACTORS_SCOPE(SelectionApply);
+
+	using namespace TransformationActorsSelection;
+
+	if (DeltaLocation.IsZero())
+	{
+		return;
+	}
+
+	const int32 Num = BeginBatch(SkipActor);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		WriteVector(BatchStreams.Locations, Index, BatchActors[Index]->GetActorLocation());
+	}
+
+	const float Delta[3] = { DeltaLocation.X, DeltaLocation.Y, DeltaLocation.Z };
+	TransformationActorsMath::TranslateLocations(BatchStreams.Locations, Num, Delta);
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		BatchActors[Index]->SetActorLocation(ReadVector(BatchStreams.Locations, Index), bSweep);
+	}
+	if (bSweep)
+	{
+		TRANSFORMATIONACTORS_COUNT_QUERIES(Num);
+	}
+}
+
+void FTransformationActorsSelection::ApplyDeltaRotation(const FQuat& DeltaRotation, const FVector& Pivot, bool bSweep, const AActor* SkipActor)
+{
+	TRANSFORMATIONACTORS_SCOPE(SelectionApply);
+
+	using namespace TransformationActorsSelection;
+
+	if (DeltaRotation.Equals(FQuat::Identity))
+	{
+		return;
+	}
+
+	const int32 Num = BeginBatch(SkipActor);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const AActor* Actor = BatchActors[Index];
+		WriteVector(BatchStreams.Locations, Index, Actor->GetActorLocation());
+		WriteQuat(BatchStreams.Rotations, Index, Actor->GetActorQuat());
+	}
+
+	/*The actors are rotated around their own origins and their offsets from the pivot are rotated too.*/
+	const float Rotation[4] = { DeltaRotation.X, DeltaRotation.Y, DeltaRotation.Z, DeltaRotation.W };
+	const float PivotLocation[3] = { Pivot.X, Pivot.Y, Pivot.Z };
+	TransformationActorsMath::RotateAroundPivot(BatchStreams.Locations, BatchStreams.Rotations, Num, Rotation, PivotLocation);
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		BatchActors[Index]->SetActorLocationAndRotation(ReadVector(BatchStreams.Locations, Index), ReadQuat(BatchStreams.Rotations, Index), bSweep);
+	}
+	if (bSweep)
+	{
+		TRANSFORMATIONACTORS_COUNT_QUERIES(Num);
+	}
+}
+
+void FTransformationActorsSelection::ApplyScaleRatio(const FVector& ScaleRatio, float MinScale, const AActor* SkipActor)
+{
+	TRANSFORMATIONACTORS_SCOPE(SelectionApply);
+
+	using namespace TransformationActorsSelection;
+
+	const int32 Num = BeginBatch(SkipActor);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		WriteVector(BatchStreams.Scales, Index, StartTransforms[BatchIndices[Index]].GetScale3D());
+	}
+
+	/*Limit the minimum scale: the actors with a too small new scale keep the current one.*/
+	const float Ratio[3] = { ScaleRatio.X, ScaleRatio.Y, ScaleRatio.Z };
+	TransformationActorsMath::MultiplyScalesClamped(BatchStreams.Scales, BatchStreams.Scales, Num, Ratio, MinScale, BatchIsValid.GetData());
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (BatchIsValid[Index])
+		{
+			BatchActors[Index]->SetActorScale3D(ReadVector(BatchStreams.Scales, Index));
+		}
+	}
+}
+
+void FTransformationActorsSelection::ApplyDeltaScale(const FVector& DeltaScale3D, float MinScale, const AActor* SkipActor)
+{
+	TRANSFORMATIONACTORS_SCOPE(SelectionApply);
+
+	using namespace TransformationActorsSelection;
+
+	const int32 Num = BeginBatch(SkipActor);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		WriteVector(BatchStreams.Scales, Index, BatchActors[Index]->GetActorScale3D());
+	}
+
+	/*Limit the minimum scale: the actors with a too small new scale keep the current one.*/
+	const float Delta[3] = { DeltaScale3D.X, DeltaScale3D.Y, DeltaScale3D.Z };
+	TransformationActorsMath::AddScalesClamped(BatchStreams.Scales, BatchStreams.Scales, Num, Delta, MinScale, BatchIsValid.GetData());
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (BatchIsValid[Index])
+		{
+			BatchActors[Index]->SetActorScale3D(ReadVector(BatchStreams.Scales, Index));
+		}
+	}
+}
+
+void FTransformationActorsSelection::ApplyDeltaTransform(const FVector& DeltaLocation, const FQuat& DeltaRotation, const FVector& Pivot, const FVector& DeltaScale3D, float MinScale, bool bSweep, const AActor* SkipActor)
+{
+	TRANSFORMATIONACTORS_SCOPE(SelectionApply);
+
+	using namespace TransformationActorsSelection;
+
+	const int32 Num = BeginBatch(SkipActor);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const AActor* Actor = BatchActors[Index];
+		WriteVector(BatchStreams.Locations, Index, Actor->GetActorLocation());
+		WriteQuat(BatchStreams.Rotations, Index, Actor->GetActorQuat());
+		WriteVector(BatchStreams.Scales, Index, Actor->GetActorScale3D());
+	}
+
+	const float Delta[3] = { DeltaLocation.X, DeltaLocation.Y, DeltaLocation.Z };
+	TransformationActorsMath::TranslateLocations(BatchStreams.Locations, Num, Delta);
+
+	const float Rotation[4] = { DeltaRotation.X, DeltaRotation.Y, DeltaRotation.Z, DeltaRotation.W };
+	const float PivotLocation[3] = { Pivot.X, Pivot.Y, Pivot.Z };
+	TransformationActorsMath::RotateAroundPivot(BatchStreams.Locations, BatchStreams.Rotations, Num, Rotation, PivotLocation);
+
+	const float ScaleDelta[3] = { DeltaScale3D.X, DeltaScale3D.Y, DeltaScale3D.Z };
+	TransformationActorsMath::AddScalesClamped(BatchStreams.Scales, BatchStreams.Scales, Num, ScaleDelta, MinScale, BatchIsValid.GetData());
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		AActor* Actor = BatchActors[Index];
+
+		/*Limit the minimum scale: the actors with a too small new scale keep the current one.*/
+		const FVector Scale3D = BatchIsValid[Index] ? ReadVector(BatchStreams.Scales, Index) : Actor->GetActorScale3D();
+
+		Actor->SetActorTransform(FTransform(ReadQuat(BatchStreams.Rotations, Index), ReadVector(BatchStreams.Locations, Index), Scale3D), bSweep);
+	}
+	if (bSweep)
+	{
+		TRANSFORMATIONACTORS_COUNT_QUERIES(Num);
+	}
+}
+
+int32 FTransformationActorsSelection::BeginBatch(const AActor* SkipActor)
+{
+	BatchActors.Reset(Actors.Num());
+	BatchIndices.Reset(Actors.Num());
+
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		AActor* Actor = Actors[Index].Get();
+		if (Actor && Actor != SkipActor)
+		{
+			BatchActors.Add(Actor);
+			BatchIndices.Add(Index);
+		}
+	}
+
+	const int32 Num = BatchActors.Num();
+	BatchBuffer.SetNumUninitialized(static_cast<int32>(TransformationActorsMath::FTransformStreams::GetBufferSize(Num)), false);
+	BatchIsValid.SetNumUninitialized(Num, false);
+	BatchStreams.Bind(BatchBuffer.GetData(), Num);
+
+	return Num;
+}
@@ -0,0 +1,68 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsSmoothing.h"
+
+FTransformationActorsLocationSpring::FTransformationActorsLocationSpring()
+	: Location(FVector::ZeroVector)
+	, Velocity(FVector::ZeroVector)
+	, LastTarget(FVector::ZeroVector)
+	, LastRawTarget(FVector::ZeroVector)
+	, TargetVelocity(FVector::ZeroVector)
+	, bIsFirstUpdate(true)
+{
+}
+
+void FTransformationActorsLocationSpring::Reset(const FVector& InLocation)
+{
+	Location = InLocation;
+	Velocity = FVector::ZeroVector;
+	LastTarget = InLocation;
+	LastRawTarget = InLocation;
+	TargetVelocity = FVector::ZeroVector;
+	bIsFirstUpdate = true;
+}
+
+FVector FTransformationActorsLocationSpring::Update(const FVector& Target, float DeltaTime, float SmoothingTime, float LeadTime)
+{
+	if (DeltaTime <= 0.f)
+	{
+		return Location;
+	}
+
+	if (SmoothingTime <= KINDA_SMALL_NUMBER)
+	{
+		Reset(Target);
+		bIsFirstUpdate = false;
+		return Location;
+	}
+
+	const float Omega = 2.f / SmoothingTime;
+	const float Decay = FMath::Exp(-Omega * DeltaTime);
+
+	/*The lead uses the velocity of the cursor smoothed with the same time constant, so it does not amplify the jitter.*/
+	if (!bIsFirstUpdate)
+	{
+		const FVector RawTargetVelocity = (Target - LastRawTarget) / DeltaTime;
+		TargetVelocity = FMath::Lerp(RawTargetVelocity, TargetVelocity, Decay);
+	}
+	const FVector LedTarget = Target + TargetVelocity * LeadTime;
+
+	/*
+	The target moves linearly from LastTarget to LedTarget. With the constant target velocity the spring settles
+	at Lag behind the target, and the distance from that point is a free critically damped oscillation.
+	*/
+	const FVector MoveVelocity = bIsFirstUpdate ? FVector::ZeroVector : (LedTarget - LastTarget) / DeltaTime;
+	const FVector Lag = MoveVelocity * SmoothingTime;
+	const FVector Offset = Location - LastTarget + Lag;
+	const FVector OffsetVelocity = Velocity - MoveVelocity;
+	const FVector Temp = (OffsetVelocity + Offset * Omega) * DeltaTime;
+
+	Location = LedTarget - Lag + (Offset + Temp) * Decay;
+	Velocity = MoveVelocity + (OffsetVelocity - Temp * Omega) * Decay;
+	LastTarget = LedTarget;
+	LastRawTarget = Target;
+	bIsFirstUpdate = false;
+
+	return Location;
+}
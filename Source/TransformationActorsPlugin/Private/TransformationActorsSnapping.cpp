@@ -0,0 +1,51 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsSnapping.h"
+
+FTransformationActorsSnapper::FTransformationActorsSnapper()
+	: LocationKernel(&SnapLocationKernel<false, true>)
+	, RotationKernel(&SnapRotationKernel<false, true>)
+	, ScaleKernel(&SnapScaleKernel<false>)
+	, LocationGrid(0.f)
+	, RotationStep(0.f)
+	, ScaleStep(0.f)
+	, Space(FTransform::Identity)
+{
+}
+
+void FTransformationActorsSnapper::Configure(float InLocationGrid, float InRotationStep, float InScaleStep, bool bIsWorldSpace, const FTransform& InSpace)
+{
+	LocationGrid = FMath::Max(InLocationGrid, 0.f);
+	RotationStep = FMath::Max(InRotationStep, 0.f);
+	ScaleStep = FMath::Max(InScaleStep, 0.f);
+	Space = InSpace;
+
+	if (!IsLocationSnapEnabled())
+	{
+		LocationKernel = &SnapLocationKernel<false, true>;
+	}
+	else if (bIsWorldSpace)
+	{
+		LocationKernel = &SnapLocationKernel<true, true>;
+	}
+	else
+	{
+		LocationKernel = &SnapLocationKernel<true, false>;
+	}
+
+	if (!IsRotationSnapEnabled())
+	{
+		RotationKernel = &SnapRotationKernel<false, true>;
+	}
+	else if (bIsWorldSpace)
+	{
+		RotationKernel = &SnapRotationKernel<true, true>;
+	}
+	else
+	{
+		RotationKernel = &SnapRotationKernel<true, false>;
+	}
+
+	ScaleKernel = IsScaleSnapEnabled() ? &SnapScaleKernel<true> : &SnapScaleKernel<false>;
+}
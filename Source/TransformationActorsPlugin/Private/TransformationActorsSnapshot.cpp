@@ -0,0 +1,292 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsSnapshot.h"
+#include "TransformationActorsStats.h"
+#include "GameFramework/Actor.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+namespace TransformationActorsSnapshot
+{
+	/*The time is checked once per this number of records.*/
+	const int32 RecordsPerTimeCheck = 256;
+
+	/*Minimum sizes in the file: an empty name is its length, an actor is its name and its record of the level index, location, rotation and scale.*/
+	const int64 MinLevelSize = sizeof(int32);
+	const int64 MinActorSize = sizeof(int32) + sizeof(int32) + sizeof(float) * (3 + 4 + 3);
+
+	/*The counts read from the file are limited by the rest of the file, so a damaged file can't reserve a huge memory.*/
+	bool IsCountInFile(FArchive& Ar, int32 Count, int64 MinItemSize)
+	{
+		return Count >= 0 && Count * MinItemSize <= Ar.TotalSize() - Ar.Tell();
+	}
+
+	/*Relative file names are resolved in the Saved directory of the project.*/
+	FString GetFilePath(const FString& FileName)
+	{
+		if (FPaths::IsRelative(FileName))
+		{
+			return FPaths::Combine(FPaths::ProjectSavedDir(), FileName);
+		}
+		return FileName;
+	}
+}
+
+const uint32 FTransformationActorsSnapshot::Magic = 0x4E534154;
+const int32 FTransformationActorsSnapshot::Version = 1;
+
+FTransformationActorsSnapshot::FTransformationActorsSnapshot()
+	: NextRecord(0)
+	, NumMissingActors(0)
+{
+}
+
+FTransformationActorsSnapshot::~FTransformationActorsSnapshot()
+{
+	CancelRestore();
+}
+
+bool FTransformationActorsSnapshot::SaveToFile(const TArray<AActor*>& Actors, const FString& FileName)
+{
+	TArray<FString> LevelNames;
+	TMap<const ULevel*, int32> IndexByLevel;
+	TArray<FString> ActorNames;
+	TArray<int32> LevelIndices;
+	TArray<const AActor*> SavedActors;
+
+	for (const AActor* Actor : Actors)
+	{
+		const ULevel* Level = Actor ? Actor->GetLevel() : nullptr;
+		if (Level == nullptr)
+		{
+			continue;
+		}
+
+		int32* LevelIndex = IndexByLevel.Find(Level);
+		if (LevelIndex == nullptr)
+		{
+			LevelIndex = &IndexByLevel.Add(Level, LevelNames.Add(GetLevelName(Level)));
+		}
+
+		ActorNames.Add(Actor->GetName());
+		LevelIndices.Add(*LevelIndex);
+		SavedActors.Add(Actor);
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TransformationActorsSnapshot::GetFilePath(FileName)));
+	if (!Writer.IsValid())
+	{
+		return false;
+	}
+
+	uint32 FileMagic = Magic;
+	int32 FileVersion = Version;
+	*Writer << FileMagic;
+	*Writer << FileVersion;
+
+	int32 NumLevels = LevelNames.Num();
+	*Writer << NumLevels;
+	for (FString& LevelName : LevelNames)
+	{
+		*Writer << LevelName;
+	}
+
+	int32 NumActors = ActorNames.Num();
+	*Writer << NumActors;
+	for (FString& ActorName : ActorNames)
+	{
+		*Writer << ActorName;
+	}
+
+	for (int32 Index = 0; Index < SavedActors.Num(); ++Index)
+	{
+		FVector Location = SavedActors[Index]->GetActorLocation();
+		FQuat Rotation = SavedActors[Index]->GetActorQuat();
+		FVector Scale3D = SavedActors[Index]->GetActorScale3D();
+
+		*Writer << LevelIndices[Index];
+		*Writer << Location;
+		*Writer << Rotation;
+		*Writer << Scale3D;
+	}
+
+	const bool bIsSaved = !Writer->IsError();
+	Writer->Close();
+
+	return bIsSaved && !Writer->IsError();
+}
+
+bool FTransformationActorsSnapshot::BeginRestore(UWorld* World, const FString& FileName)
+{
+	CancelRestore();
+
+	RestoredActors.Reset();
+	NumMissingActors = 0;
+	NextRecord = 0;
+
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	Reader.Reset(IFileManager::Get().CreateFileReader(*TransformationActorsSnapshot::GetFilePath(FileName)));
+	if (!Reader.IsValid())
+	{
+		return false;
+	}
+
+	uint32 FileMagic = 0;
+	int32 FileVersion = 0;
+	*Reader << FileMagic;
+	*Reader << FileVersion;
+
+	int32 NumLevels = 0;
+	*Reader << NumLevels;
+
+	if (Reader->IsError() || FileMagic != Magic || FileVersion < 1 || FileVersion > Version || !TransformationActorsSnapshot::IsCountInFile(*Reader, NumLevels, TransformationActorsSnapshot::MinLevelSize))
+	{
+		CancelRestore();
+		return false;
+	}
+
+	/*The levels are matched by name once, the records refer to them by index.*/
+	TMap<FString, ULevel*> LevelByName;
+	for (ULevel* Level : World->GetLevels())
+	{
+		if (Level)
+		{
+			LevelByName.Add(GetLevelName(Level), Level);
+		}
+	}
+
+	Levels.Reset(NumLevels);
+	for (int32 Index = 0; Index < NumLevels; ++Index)
+	{
+		FString LevelName;
+		*Reader << LevelName;
+
+		ULevel** Level = LevelByName.Find(LevelName);
+		Levels.Add(Level ? *Level : nullptr);
+	}
+
+	int32 NumActors = 0;
+	*Reader << NumActors;
+	if (Reader->IsError() || !TransformationActorsSnapshot::IsCountInFile(*Reader, NumActors, TransformationActorsSnapshot::MinActorSize))
+	{
+		CancelRestore();
+		return false;
+	}
+
+	ActorNames.Reset(NumActors);
+	FString ActorName;
+	for (int32 Index = 0; Index < NumActors; ++Index)
+	{
+		*Reader << ActorName;
+		ActorNames.Add(FName(*ActorName));
+	}
+
+	if (Reader->IsError())
+	{
+		CancelRestore();
+		return false;
+	}
+
+	RestoreWorld = World;
+	RestoredActors.Reserve(NumActors);
+
+	return true;
+}
+
+bool FTransformationActorsSnapshot::RestoreBatch(double TimeBudgetSeconds, TFunctionRef<void(AActor*)> OnBeforeRestore)
+{
+	TRANSFORMATIONACTORS_SCOPE(Snapshot);
+
+	using namespace TransformationActorsSnapshot;
+
+	if (!Reader.IsValid())
+	{
+		return true;
+	}
+
+	if (!RestoreWorld.IsValid())
+	{
+		CancelRestore();
+		return true;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + TimeBudgetSeconds;
+
+	while (NextRecord < ActorNames.Num())
+	{
+		int32 LevelIndex = INDEX_NONE;
+		FVector Location;
+		FQuat Rotation;
+		FVector Scale3D;
+
+		*Reader << LevelIndex;
+		*Reader << Location;
+		*Reader << Rotation;
+		*Reader << Scale3D;
+
+		if (Reader->IsError())
+		{
+			NumMissingActors += ActorNames.Num() - NextRecord;
+			CancelRestore();
+			return true;
+		}
+
+		ULevel* Level = Levels.IsValidIndex(LevelIndex) ? Levels[LevelIndex].Get() : nullptr;
+		AActor* Actor = Level ? FindObjectFast<AActor>(Level, ActorNames[NextRecord]) : nullptr;
+
+		if (Actor && !Actor->IsPendingKill())
+		{
+			OnBeforeRestore(Actor);
+
+			Rotation.Normalize();
+			Actor->SetActorTransform(FTransform(Rotation, Location, Scale3D), false, nullptr, ETeleportType::TeleportPhysics);
+			RestoredActors.Add(Actor);
+		}
+		else
+		{
+			++NumMissingActors;
+		}
+
+		++NextRecord;
+
+		if (NextRecord % RecordsPerTimeCheck == 0 && FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+
+	if (NextRecord < ActorNames.Num())
+	{
+		return false;
+	}
+
+	CancelRestore();
+	return true;
+}
+
+void FTransformationActorsSnapshot::CancelRestore()
+{
+	if (Reader.IsValid())
+	{
+		Reader->Close();
+		Reader.Reset();
+	}
+
+	Levels.Reset();
+	ActorNames.Reset();
+	RestoreWorld.Reset();
+}
+
+FString FTransformationActorsSnapshot::GetLevelName(const ULevel* Level)
+{
+	return UWorld::RemovePIEPrefix(Level->GetOutermost()->GetName());
+}
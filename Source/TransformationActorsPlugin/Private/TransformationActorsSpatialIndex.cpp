@@ -0,0 +1,536 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsSpatialIndex.h"
+#include "TransformationActorsStats.h"
+#include "TransformationActorsInterfaceCache.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "CollisionQueryParams.h"
+#include "ConvexVolume.h"
+#include "Async/ParallelFor.h"
+
+TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FTransformationActorsSpatialIndex>> FTransformationActorsSpatialIndex::IndexByWorld;
+FDelegateHandle FTransformationActorsSpatialIndex::LevelAddedHandle;
+FDelegateHandle FTransformationActorsSpatialIndex::WorldCleanupHandle;
+
+namespace TransformationActorsSpatialIndex
+{
+	/*Maximum number of items in a leaf.*/
+	const int32 MaxItemsPerLeaf = 4;
+
+	/*The hierarchy is rebuilt when the number of the items outside of it exceeds max(MinPendingItemsToRebuild, Num / PendingItemsRebuildDivisor).*/
+	const int32 MinPendingItemsToRebuild = 32;
+	const int32 PendingItemsRebuildDivisor = 8;
+
+	/*Number of items tested by one task of OverlapFrustum().*/
+	const int32 FrustumItemsPerTask = 2048;
+}
+
+FTransformationActorsSpatialIndex* FTransformationActorsSpatialIndex::Get(UWorld* World)
+{
+	check(IsInGameThread());
+
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (TSharedPtr<FTransformationActorsSpatialIndex>* Index = IndexByWorld.Find(World))
+	{
+		return Index->Get();
+	}
+
+	return IndexByWorld.Add(World, MakeShared<FTransformationActorsSpatialIndex>(World)).Get();
+}
+
+void FTransformationActorsSpatialIndex::Startup()
+{
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddStatic(&FTransformationActorsSpatialIndex::OnLevelAdded);
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FTransformationActorsSpatialIndex::OnWorldCleanup);
+}
+
+void FTransformationActorsSpatialIndex::Shutdown()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	LevelAddedHandle.Reset();
+	WorldCleanupHandle.Reset();
+
+	IndexByWorld.Empty();
+}
+
+FTransformationActorsSpatialIndex::FTransformationActorsSpatialIndex(UWorld* InWorld)
+	: World(InWorld)
+	, NumRemovedItems(0)
+{
+	ActorSpawnedHandle = InWorld->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateRaw(this, &FTransformationActorsSpatialIndex::OnActorSpawned));
+
+	for (TActorIterator<AActor> It(InWorld); It; ++It)
+	{
+		AddActor(*It);
+	}
+}
+
+FTransformationActorsSpatialIndex::~FTransformationActorsSpatialIndex()
+{
+	if (UWorld* CurrentWorld = World.Get())
+	{
+		CurrentWorld->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	for (int32 Item = 0; Item < RootComponents.Num(); ++Item)
+	{
+		if (USceneComponent* RootComponent = RootComponents[Item].Get())
+		{
+			RootComponent->TransformUpdated.Remove(TransformUpdatedHandles[Item]);
+		}
+	}
+}
+
+void FTransformationActorsSpatialIndex::AddActor(AActor* Actor)
+{
+	if (Actor == nullptr || Actor->IsPendingKill() || IndexByActor.Contains(Actor) || !FTransformationActorsInterfaceCache::Implements(Actor))
+	{
+		return;
+	}
+
+	const int32 Item = Actors.Add(Actor);
+	Bounds.Add(FBox(ForceInit));
+	LeafByItem.Add(INDEX_NONE);
+	bIsDirtyByItem.Add(true);
+	IndexByActor.Add(Actor, Item);
+
+	/*The bounds are calculated in the next Refresh().*/
+	DirtyItems.Add(Item);
+	PendingItems.Add(Item);
+
+	USceneComponent* RootComponent = Actor->GetRootComponent();
+	RootComponents.Add(RootComponent);
+	TransformUpdatedHandles.Add(RootComponent
+		? RootComponent->TransformUpdated.AddRaw(this, &FTransformationActorsSpatialIndex::OnRootTransformUpdated)
+		: FDelegateHandle());
+}
+
+void FTransformationActorsSpatialIndex::RemoveActor(AActor* Actor)
+{
+	int32 Item = INDEX_NONE;
+	if (!IndexByActor.RemoveAndCopyValue(Actor, Item))
+	{
+		return;
+	}
+
+	if (USceneComponent* RootComponent = RootComponents[Item].Get())
+	{
+		RootComponent->TransformUpdated.Remove(TransformUpdatedHandles[Item]);
+	}
+
+	/*The place of the item is freed in the next Rebuild().*/
+	Actors[Item] = nullptr;
+	RootComponents[Item] = nullptr;
+	TransformUpdatedHandles[Item].Reset();
+	++NumRemovedItems;
+
+	if (!bIsDirtyByItem[Item])
+	{
+		bIsDirtyByItem[Item] = true;
+		DirtyItems.Add(Item);
+	}
+}
+
+void FTransformationActorsSpatialIndex::MarkActorDirty(AActor* Actor)
+{
+	const int32* Item = IndexByActor.Find(Actor);
+	if (Item && !bIsDirtyByItem[*Item])
+	{
+		bIsDirtyByItem[*Item] = true;
+		DirtyItems.Add(*Item);
+	}
+}
+
+AActor* FTransformationActorsSpatialIndex::Raycast(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, bool bTestOcclusion, FHitResult& OutHit)
+{
+	TRANSFORMATIONACTORS_SCOPE(SpatialIndexQuery);
+
+	UWorld* CurrentWorld = World.Get();
+	if (CurrentWorld == nullptr)
+	{
+		return nullptr;
+	}
+
+	Refresh();
+
+	const FVector Delta = End - Start;
+	const FVector InvDelta(
+		Delta.X != 0.f ? 1.f / Delta.X : BIG_NUMBER,
+		Delta.Y != 0.f ? 1.f / Delta.Y : BIG_NUMBER,
+		Delta.Z != 0.f ? 1.f / Delta.Z : BIG_NUMBER);
+
+	/*Collect the items whose bounds are crossed by the segment.*/
+	Candidates.Reset();
+	float Time;
+
+	if (Nodes.Num() > 0)
+	{
+		NodeStack.Reset();
+		NodeStack.Add(0);
+
+		while (NodeStack.Num() > 0)
+		{
+			const int32 NodeIndex = NodeStack.Pop(false);
+			const FNode& Node = Nodes[NodeIndex];
+			if (!IntersectSegmentBox(Node.Bounds, Start, InvDelta, Time))
+			{
+				continue;
+			}
+
+			if (Node.NumItems > 0)
+			{
+				for (int32 Order = Node.FirstItem; Order < Node.FirstItem + Node.NumItems; ++Order)
+				{
+					const int32 Item = ItemOrder[Order];
+					if (IntersectSegmentBox(Bounds[Item], Start, InvDelta, Time))
+					{
+						Candidates.Add({ Item, Time });
+					}
+				}
+			}
+			else
+			{
+				NodeStack.Add(Node.RightChild);
+				NodeStack.Add(NodeIndex + 1);
+			}
+		}
+	}
+
+	for (const int32 Item : PendingItems)
+	{
+		if (IntersectSegmentBox(Bounds[Item], Start, InvDelta, Time))
+		{
+			Candidates.Add({ Item, Time });
+		}
+	}
+
+	if (Candidates.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Time < B.Time; });
+
+	/*Test the simple collision of the candidates while their bounds are closer than the nearest hit.*/
+	const FCollisionQueryParams Params(FName(TEXT("TransformationActorsPicking")), false);
+	AActor* HitActor = nullptr;
+	float HitTime = 1.f;
+
+	for (const FCandidate& Candidate : Candidates)
+	{
+		if (Candidate.Time > HitTime)
+		{
+			break;
+		}
+
+		AActor* Actor = Actors[Candidate.Item].Get();
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		FHitResult Hit;
+		TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+		if (Actor->ActorLineTraceSingle(Hit, Start, End, TraceChannel, Params) && Hit.Time <= HitTime)
+		{
+			HitTime = Hit.Time;
+			HitActor = Actor;
+			OutHit = Hit;
+		}
+	}
+
+	if (HitActor && bTestOcclusion)
+	{
+		const FCollisionQueryParams OcclusionParams(FName(TEXT("TransformationActorsPickingOcclusion")), false, HitActor);
+		TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+		if (CurrentWorld->LineTraceTestByChannel(Start, OutHit.Location, TraceChannel, OcclusionParams))
+		{
+			return nullptr;
+		}
+	}
+
+	return HitActor;
+}
+
+void FTransformationActorsSpatialIndex::OverlapFrustum(const FConvexVolume& Frustum, TArray<AActor*>& OutActors)
+{
+	TRANSFORMATIONACTORS_SCOPE(SpatialIndexQuery);
+
+	using namespace TransformationActorsSpatialIndex;
+
+	OutActors.Reset();
+
+	if (!World.IsValid())
+	{
+		return;
+	}
+
+	Refresh();
+
+	const int32 NumItems = Bounds.Num();
+	bIsInFrustumByItem.SetNumUninitialized(NumItems, false);
+
+	/*The tasks only read the bounds and write their own range of the flags.*/
+	const int32 NumTasks = FMath::DivideAndRoundUp(NumItems, FrustumItemsPerTask);
+	ParallelFor(NumTasks, [this, &Frustum, NumItems](int32 Task)
+	{
+		const int32 EndItem = FMath::Min((Task + 1) * FrustumItemsPerTask, NumItems);
+		for (int32 Item = Task * FrustumItemsPerTask; Item < EndItem; ++Item)
+		{
+			const FBox& Box = Bounds[Item];
+			bIsInFrustumByItem[Item] = Box.IsValid && Frustum.IntersectBox(Box.GetCenter(), Box.GetExtent());
+		}
+	});
+
+	/*The actors are resolved in the game thread.*/
+	for (int32 Item = 0; Item < NumItems; ++Item)
+	{
+		if (bIsInFrustumByItem[Item])
+		{
+			if (AActor* Actor = Actors[Item].Get())
+			{
+				OutActors.Add(Actor);
+			}
+		}
+	}
+}
+
+void FTransformationActorsSpatialIndex::AddLevelActors(ULevel* Level)
+{
+	for (AActor* Actor : Level->Actors)
+	{
+		AddActor(Actor);
+	}
+}
+
+void FTransformationActorsSpatialIndex::Refresh()
+{
+	TRANSFORMATIONACTORS_SCOPE(SpatialIndexUpdate);
+
+	using namespace TransformationActorsSpatialIndex;
+
+	for (const int32 Item : DirtyItems)
+	{
+		bIsDirtyByItem[Item] = false;
+
+		const AActor* Actor = Actors[Item].Get();
+		Bounds[Item] = Actor ? CalcActorBounds(Actor) : FBox(ForceInit);
+
+		/*Mark the leaf and its parents for the refit.*/
+		for (int32 NodeIndex = LeafByItem[Item]; NodeIndex != INDEX_NONE && !bIsDirtyByNode[NodeIndex]; NodeIndex = Nodes[NodeIndex].Parent)
+		{
+			bIsDirtyByNode[NodeIndex] = true;
+		}
+	}
+	const bool bIsNeedRefit = DirtyItems.Num() > 0;
+	DirtyItems.Reset();
+
+	const int32 MaxPendingItems = FMath::Max(MinPendingItemsToRebuild, Actors.Num() / PendingItemsRebuildDivisor);
+	if (PendingItems.Num() > MaxPendingItems || NumRemovedItems > MaxPendingItems)
+	{
+		Rebuild();
+		return;
+	}
+
+	if (!bIsNeedRefit)
+	{
+		return;
+	}
+
+	/*The children are always stored after the parent, so the reverse pass refits the hierarchy bottom-up.*/
+	for (int32 NodeIndex = Nodes.Num() - 1; NodeIndex >= 0; --NodeIndex)
+	{
+		if (!bIsDirtyByNode[NodeIndex])
+		{
+			continue;
+		}
+		bIsDirtyByNode[NodeIndex] = false;
+
+		FNode& Node = Nodes[NodeIndex];
+		if (Node.NumItems > 0)
+		{
+			Node.Bounds = FBox(ForceInit);
+			for (int32 Order = Node.FirstItem; Order < Node.FirstItem + Node.NumItems; ++Order)
+			{
+				Node.Bounds += Bounds[ItemOrder[Order]];
+			}
+		}
+		else
+		{
+			Node.Bounds = Nodes[NodeIndex + 1].Bounds + Nodes[Node.RightChild].Bounds;
+		}
+	}
+}
+
+void FTransformationActorsSpatialIndex::Rebuild()
+{
+	TRANSFORMATIONACTORS_SCOPE(SpatialIndexUpdate);
+
+	/*Free the places of the removed and destroyed actors.*/
+	int32 NewNum = 0;
+	for (int32 Item = 0; Item < Actors.Num(); ++Item)
+	{
+		if (!Actors[Item].IsValid())
+		{
+			if (USceneComponent* RootComponent = RootComponents[Item].Get())
+			{
+				RootComponent->TransformUpdated.Remove(TransformUpdatedHandles[Item]);
+			}
+			continue;
+		}
+
+		Actors[NewNum] = Actors[Item];
+		Bounds[NewNum] = Bounds[Item];
+		RootComponents[NewNum] = RootComponents[Item];
+		TransformUpdatedHandles[NewNum] = TransformUpdatedHandles[Item];
+		++NewNum;
+	}
+
+	Actors.SetNum(NewNum);
+	Bounds.SetNum(NewNum);
+	RootComponents.SetNum(NewNum);
+	TransformUpdatedHandles.SetNum(NewNum);
+	LeafByItem.SetNum(NewNum);
+	bIsDirtyByItem.SetNum(NewNum);
+
+	IndexByActor.Reset();
+	for (int32 Item = 0; Item < NewNum; ++Item)
+	{
+		IndexByActor.Add(Actors[Item], Item);
+	}
+
+	NumRemovedItems = 0;
+
+	PendingItems.Reset();
+	Nodes.Reset();
+
+	ItemOrder.SetNumUninitialized(Actors.Num());
+	for (int32 Item = 0; Item < Actors.Num(); ++Item)
+	{
+		ItemOrder[Item] = Item;
+		LeafByItem[Item] = INDEX_NONE;
+		bIsDirtyByItem[Item] = false;
+	}
+
+	if (ItemOrder.Num() > 0)
+	{
+		BuildNode(0, ItemOrder.Num(), INDEX_NONE);
+	}
+
+	bIsDirtyByNode.Init(false, Nodes.Num());
+}
+
+int32 FTransformationActorsSpatialIndex::BuildNode(int32 FirstItem, int32 NumItems, int32 Parent)
+{
+	const int32 NodeIndex = Nodes.AddUninitialized();
+
+	FBox NodeBounds(ForceInit);
+	FBox CenterBounds(ForceInit);
+	for (int32 Order = FirstItem; Order < FirstItem + NumItems; ++Order)
+	{
+		const FBox& ItemBounds = Bounds[ItemOrder[Order]];
+		if (ItemBounds.IsValid)
+		{
+			NodeBounds += ItemBounds;
+			CenterBounds += ItemBounds.GetCenter();
+		}
+	}
+
+	Nodes[NodeIndex].Bounds = NodeBounds;
+	Nodes[NodeIndex].Parent = Parent;
+	Nodes[NodeIndex].RightChild = INDEX_NONE;
+
+	if (NumItems <= TransformationActorsSpatialIndex::MaxItemsPerLeaf || !CenterBounds.IsValid)
+	{
+		Nodes[NodeIndex].FirstItem = FirstItem;
+		Nodes[NodeIndex].NumItems = NumItems;
+		for (int32 Order = FirstItem; Order < FirstItem + NumItems; ++Order)
+		{
+			LeafByItem[ItemOrder[Order]] = NodeIndex;
+		}
+		return NodeIndex;
+	}
+
+	/*Split by the median along the longest axis of the centers.*/
+	const FVector CenterExtent = CenterBounds.GetExtent();
+	const int32 Axis = (CenterExtent.X >= CenterExtent.Y && CenterExtent.X >= CenterExtent.Z) ? 0 : (CenterExtent.Y >= CenterExtent.Z ? 1 : 2);
+
+	Sort(ItemOrder.GetData() + FirstItem, NumItems, [this, Axis](const int32 A, const int32 B)
+	{
+		return Bounds[A].GetCenter()[Axis] < Bounds[B].GetCenter()[Axis];
+	});
+
+	const int32 NumLeftItems = NumItems / 2;
+
+	Nodes[NodeIndex].FirstItem = INDEX_NONE;
+	Nodes[NodeIndex].NumItems = 0;
+
+	BuildNode(FirstItem, NumLeftItems, NodeIndex);
+	const int32 RightChild = BuildNode(FirstItem + NumLeftItems, NumItems - NumLeftItems, NodeIndex);
+	Nodes[NodeIndex].RightChild = RightChild;
+
+	return NodeIndex;
+}
+
+FBox FTransformationActorsSpatialIndex::CalcActorBounds(const AActor* Actor)
+{
+	/*Only the colliding components can be hit by the trace.*/
+	return Actor->GetComponentsBoundingBox(false);
+}
+
+bool FTransformationActorsSpatialIndex::IntersectSegmentBox(const FBox& Box, const FVector& Start, const FVector& InvDelta, float& OutTime)
+{
+	if (!Box.IsValid)
+	{
+		return false;
+	}
+
+	float TimeMin = 0.f;
+	float TimeMax = 1.f;
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const float Time1 = (Box.Min[Axis] - Start[Axis]) * InvDelta[Axis];
+		const float Time2 = (Box.Max[Axis] - Start[Axis]) * InvDelta[Axis];
+		TimeMin = FMath::Max(TimeMin, FMath::Min(Time1, Time2));
+		TimeMax = FMath::Min(TimeMax, FMath::Max(Time1, Time2));
+	}
+
+	OutTime = TimeMin;
+	return TimeMin <= TimeMax;
+}
+
+void FTransformationActorsSpatialIndex::OnActorSpawned(AActor* Actor)
+{
+	AddActor(Actor);
+}
+
+void FTransformationActorsSpatialIndex::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (UpdatedComponent)
+	{
+		MarkActorDirty(UpdatedComponent->GetOwner());
+	}
+}
+
+void FTransformationActorsSpatialIndex::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (TSharedPtr<FTransformationActorsSpatialIndex>* Index = IndexByWorld.Find(World))
+	{
+		(*Index)->AddLevelActors(Level);
+	}
+}
+
+void FTransformationActorsSpatialIndex::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	IndexByWorld.Remove(World);
+}
@@ -0,0 +1,31 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsStats.h"
+
+DEFINE_STAT(STAT_TransformationActors_Tick);
+DEFINE_STAT(STAT_TransformationActors_Update);
+DEFINE_STAT(STAT_TransformationActors_Picking);
+DEFINE_STAT(STAT_TransformationActors_Deprojection);
+DEFINE_STAT(STAT_TransformationActors_TransformComposition);
+DEFINE_STAT(STAT_TransformationActors_Sweep);
+DEFINE_STAT(STAT_TransformationActors_SelectionApply);
+DEFINE_STAT(STAT_TransformationActors_InterfaceDispatch);
+DEFINE_STAT(STAT_TransformationActors_SpatialIndexQuery);
+DEFINE_STAT(STAT_TransformationActors_SpatialIndexUpdate);
+DEFINE_STAT(STAT_TransformationActors_History);
+DEFINE_STAT(STAT_TransformationActors_NetSession);
+DEFINE_STAT(STAT_TransformationActors_Snapshot);
+DEFINE_STAT(STAT_TransformationActors_InstanceUpdate);
+DEFINE_STAT(STAT_TransformationActors_Validation);
+DEFINE_STAT(STAT_TransformationActors_Commands);
+DEFINE_STAT(STAT_TransformationActors_ChangeEvents);
+DEFINE_STAT(STAT_TransformationActors_MovementUpdate);
+
+DEFINE_STAT(STAT_TransformationActors_ActiveSessions);
+DEFINE_STAT(STAT_TransformationActors_ActorsMoved);
+DEFINE_STAT(STAT_TransformationActors_SceneQueries);
+
+FThreadSafeCounter GTransformationActorsSceneQueries;
+
+CSV_DEFINE_CATEGORY_MODULE(TRANSFORMATIONACTORSPLUGIN_API, TransformationActors, true);
@@ -0,0 +1,128 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsSurfacePlacement.h"
+#include "TransformationActorsStats.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+namespace TransformationActorsSurfacePlacement
+{
+	/*The ray is not traced again while its ends move less than this.*/
+	const float RayTolerance = 0.1f;
+}
+
+FTransformationActorsSurfacePlacement::FTransformationActorsSurfacePlacement()
+	: LocalBounds(ForceInit)
+	, StartRotation(FQuat::Identity)
+	, Params(FName(TEXT("TransformationActorsSurface")), true)
+	, TraceChannel(ECC_Visibility)
+	, bIsTracePending(false)
+	, LastRayStart(FVector::ZeroVector)
+	, LastRayEnd(FVector::ZeroVector)
+	, bHasRay(false)
+	, bHasSurface(false)
+	, SurfaceLocation(FVector::ZeroVector)
+	, SurfaceNormal(FVector::UpVector)
+{
+}
+
+void FTransformationActorsSurfacePlacement::Begin(AActor* Actor, const TArray<AActor*>& IgnoredActors, ECollisionChannel InTraceChannel)
+{
+	LocalBounds = Actor ? Actor->CalculateComponentsBoundingBoxInLocalSpace() : FBox(ForceInit);
+	StartRotation = Actor ? Actor->GetActorQuat() : FQuat::Identity;
+
+	Params = FCollisionQueryParams(FName(TEXT("TransformationActorsSurface")), true, Actor);
+	Params.AddIgnoredActors(IgnoredActors);
+	TraceChannel = InTraceChannel;
+
+	/*The result of the trace of the previous placement is dropped.*/
+	TraceHandle = FTraceHandle();
+	bIsTracePending = false;
+	bHasRay = false;
+	bHasSurface = false;
+}
+
+void FTransformationActorsSurfacePlacement::Update(UWorld* World, const FVector& RayStart, const FVector& RayEnd, FTraceDelegate* TraceDelegate)
+{
+	using namespace TransformationActorsSurfacePlacement;
+
+	if (World == nullptr || bIsTracePending)
+	{
+		return;
+	}
+
+	if (bHasRay && LastRayStart.Equals(RayStart, RayTolerance) && LastRayEnd.Equals(RayEnd, RayTolerance))
+	{
+		return;
+	}
+
+	TRANSFORMATIONACTORS_SCOPE(Picking);
+
+	const bool bIsFirstTrace = !bHasRay;
+
+	LastRayStart = RayStart;
+	LastRayEnd = RayEnd;
+	bHasRay = true;
+
+	TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+
+	if (bIsFirstTrace)
+	{
+		FHitResult Hit;
+		const bool bIsHit = World->LineTraceSingleByChannel(Hit, RayStart, RayEnd, TraceChannel, Params);
+		SetHit(bIsHit, Hit);
+		return;
+	}
+
+	TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, RayStart, RayEnd, TraceChannel, Params, FCollisionResponseParams::DefaultResponseParam, TraceDelegate);
+	bIsTracePending = true;
+}
+
+bool FTransformationActorsSurfacePlacement::OnTraceDone(const FTraceHandle& InTraceHandle, const FTraceDatum& TraceDatum)
+{
+	if (!bIsTracePending || InTraceHandle != TraceHandle)
+	{
+		return false;
+	}
+
+	bIsTracePending = false;
+
+	const FHitResult* Hit = TraceDatum.OutHits.FindByPredicate([](const FHitResult& Result) { return Result.bBlockingHit; });
+	SetHit(Hit != nullptr, Hit ? *Hit : FHitResult());
+	return true;
+}
+
+void FTransformationActorsSurfacePlacement::SetHit(bool bIsHit, const FHitResult& Hit)
+{
+	bHasSurface = bIsHit;
+	if (bIsHit)
+	{
+		SurfaceLocation = Hit.ImpactPoint;
+		SurfaceNormal = Hit.ImpactNormal.GetSafeNormal(SMALL_NUMBER, FVector::UpVector);
+	}
+}
+
+FQuat FTransformationActorsSurfacePlacement::GetAlignedRotation() const
+{
+	return FQuat::FindBetweenNormals(StartRotation.GetUpVector(), SurfaceNormal) * StartRotation;
+}
+
+FVector FTransformationActorsSurfacePlacement::GetPlacedLocation(const FQuat& Rotation, const FVector& Scale3D, float Height) const
+{
+	if (!LocalBounds.IsValid)
+	{
+		return SurfaceLocation + SurfaceNormal * Height;
+	}
+
+	/*Half of the size of the rotated bounds along the normal.*/
+	const FVector Extent = LocalBounds.GetExtent() * Scale3D.GetAbs();
+	const float HalfHeight =
+		FMath::Abs(FVector::DotProduct(Rotation.GetAxisX(), SurfaceNormal)) * Extent.X +
+		FMath::Abs(FVector::DotProduct(Rotation.GetAxisY(), SurfaceNormal)) * Extent.Y +
+		FMath::Abs(FVector::DotProduct(Rotation.GetAxisZ(), SurfaceNormal)) * Extent.Z;
+
+	/*The center of the bounds is above the hit point, the bottom of the bounds touches it.*/
+	const FVector CenterOffset = Rotation.RotateVector(LocalBounds.GetCenter() * Scale3D);
+	return SurfaceLocation - CenterOffset + SurfaceNormal * (HalfHeight + Height);
+}
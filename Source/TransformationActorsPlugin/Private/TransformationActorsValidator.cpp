@@ -0,0 +1,244 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+
+#include "TransformationActorsValidator.h"
+#include "TransformationActorsStats.h"
+#include "TransformationActorsComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Volume.h"
+#include "CollisionQueryParams.h"
+#include "HAL/PlatformTime.h"
+
+TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FTransformationActorsValidator>> FTransformationActorsValidator::ValidatorByWorld;
+FDelegateHandle FTransformationActorsValidator::WorldCleanupHandle;
+
+namespace TransformationActorsValidator
+{
+	/*The tested box is smaller than the bounds by this, so the actors that only touch their neighbours are not rejected.*/
+	const float OverlapInset = 1.f;
+}
+
+FTransformationActorsPlacementRules::FTransformationActorsPlacementRules()
+	: MaxDistance(0.f)
+	, MinScale(0.f)
+	, bTestOverlap(false)
+	, OverlapChannel(ECC_WorldDynamic)
+{
+}
+
+FTransformationActorsValidationRequest::FTransformationActorsValidationRequest()
+	: bIsFinal(false)
+	, NextActor(0)
+{
+}
+
+FTransformationActorsValidator* FTransformationActorsValidator::Get(UWorld* World)
+{
+	check(IsInGameThread());
+
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (TSharedPtr<FTransformationActorsValidator>* Validator = ValidatorByWorld.Find(World))
+	{
+		return Validator->Get();
+	}
+
+	return ValidatorByWorld.Add(World, MakeShared<FTransformationActorsValidator>(World)).Get();
+}
+
+void FTransformationActorsValidator::Startup()
+{
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FTransformationActorsValidator::OnWorldCleanup);
+}
+
+void FTransformationActorsValidator::Shutdown()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	WorldCleanupHandle.Reset();
+
+	ValidatorByWorld.Empty();
+}
+
+FTransformationActorsValidator::FTransformationActorsValidator(UWorld* InWorld)
+	: World(InWorld)
+	, LastProcessedFrame(0)
+{
+}
+
+void FTransformationActorsValidator::Submit(UTransformationActorsComponent* Component, FTransformationActorsValidationRequest&& Request)
+{
+	/*Only the newest update of the component is tested, it keeps the place of the replaced one in the queue.*/
+	for (int32 Index = Queue.Num() - 1; Index >= 0; --Index)
+	{
+		if (Queue[Index].Component == Component)
+		{
+			if (!Queue[Index].Request.bIsFinal)
+			{
+				Queue[Index].Request = MoveTemp(Request);
+				return;
+			}
+			break;
+		}
+	}
+
+	FEntry& Entry = Queue[Queue.AddDefaulted()];
+	Entry.Component = Component;
+	Entry.Request = MoveTemp(Request);
+}
+
+void FTransformationActorsValidator::Cancel(const UTransformationActorsComponent* Component)
+{
+	Queue.RemoveAll([Component](const FEntry& Entry) { return Entry.Component == Component; });
+}
+
+void FTransformationActorsValidator::Process(int32 MaxTests, double TimeBudgetSeconds)
+{
+	TRANSFORMATIONACTORS_SCOPE(Validation);
+
+	/*All components with the queued requests call it, the queue is processed by the first one.*/
+	if (LastProcessedFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastProcessedFrame = GFrameCounter;
+
+	const double EndTime = FPlatformTime::Seconds() + TimeBudgetSeconds;
+
+	int32 NumFinished = 0;
+	while (NumFinished < Queue.Num() && MaxTests > 0)
+	{
+		if (!ProcessEntry(Queue[NumFinished], MaxTests))
+		{
+			break;
+		}
+		++NumFinished;
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+
+	Queue.RemoveAt(0, NumFinished, false);
+}
+
+void FTransformationActorsValidator::Flush(const UTransformationActorsComponent* Component)
+{
+	TRANSFORMATIONACTORS_SCOPE(Validation);
+
+	for (int32 Index = 0; Index < Queue.Num(); )
+	{
+		if (Queue[Index].Component == Component)
+		{
+			int32 MaxTests = MAX_int32;
+			ProcessEntry(Queue[Index], MaxTests);
+			Queue.RemoveAt(Index, 1, false);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+}
+
+bool FTransformationActorsValidator::IsQueued(const UTransformationActorsComponent* Component) const
+{
+	return Queue.ContainsByPredicate([Component](const FEntry& Entry) { return Entry.Component == Component; });
+}
+
+bool FTransformationActorsValidator::ProcessEntry(FEntry& Entry, int32& InOutMaxTests)
+{
+	UTransformationActorsComponent* Component = Entry.Component.Get();
+	UWorld* CurrentWorld = World.Get();
+	if (Component == nullptr || CurrentWorld == nullptr)
+	{
+		return true;
+	}
+
+	FTransformationActorsValidationRequest& Request = Entry.Request;
+
+	/*The actors of the session move together, they don't block each other.*/
+	FCollisionQueryParams Params(FName(TEXT("TransformationActorsValidation")), false);
+	for (const TWeakObjectPtr<AActor>& Actor : Request.Actors)
+	{
+		Params.AddIgnoredActor(Actor.Get());
+	}
+
+	bool bIsAccepted = true;
+	while (Request.NextActor < Request.Actors.Num())
+	{
+		if (InOutMaxTests <= 0)
+		{
+			return false;
+		}
+		--InOutMaxTests;
+
+		const int32 Index = Request.NextActor++;
+		AActor* Actor = Request.Actors[Index].Get();
+		if (Actor && !TestPlacement(CurrentWorld, Actor, Request.AcceptedTransforms[Index], Request.Transforms[Index], Request.Rules, Params))
+		{
+			bIsAccepted = false;
+			break;
+		}
+	}
+
+	Component->OnNetRequestValidated(Request, bIsAccepted);
+	return true;
+}
+
+bool FTransformationActorsValidator::TestPlacement(UWorld* World, AActor* Actor, const FTransform& AcceptedTransform, const FTransform& Transform, const FTransformationActorsPlacementRules& Rules, const FCollisionQueryParams& Params)
+{
+	using namespace TransformationActorsValidator;
+
+	const FVector Location = Transform.GetLocation();
+
+	if (Rules.MaxDistance > 0.f && FVector::DistSquared(Location, AcceptedTransform.GetLocation()) > FMath::Square(Rules.MaxDistance))
+	{
+		return false;
+	}
+
+	if (Transform.GetScale3D().GetMin() < Rules.MinScale || Transform.ContainsNaN())
+	{
+		return false;
+	}
+
+	if (Rules.Volumes.Num() > 0)
+	{
+		const bool bIsInside = Rules.Volumes.ContainsByPredicate([&Location](const TWeakObjectPtr<AVolume>& Volume)
+		{
+			return Volume.IsValid() && Volume->EncompassesPoint(Location);
+		});
+		if (!bIsInside)
+		{
+			return false;
+		}
+	}
+
+	if (Rules.bTestOverlap)
+	{
+		const FBox LocalBounds = Actor->CalculateComponentsBoundingBoxInLocalSpace();
+		if (LocalBounds.IsValid)
+		{
+			const FVector Extent = (LocalBounds.GetExtent() * Transform.GetScale3D().GetAbs() - FVector(OverlapInset)).ComponentMax(FVector(OverlapInset));
+			const FVector Center = Transform.TransformPosition(LocalBounds.GetCenter());
+
+			TRANSFORMATIONACTORS_COUNT_QUERIES(1);
+
+			if (World->OverlapBlockingTestByChannel(Center, Transform.GetRotation(), Rules.OverlapChannel, FCollisionShape::MakeBox(Extent), Params))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void FTransformationActorsValidator::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	ValidatorByWorld.Remove(World);
+}
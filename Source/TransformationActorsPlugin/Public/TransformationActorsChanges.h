@@ -0,0 +1,63 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Templates/Function.h"
+
+class AActor;
+
+/*Change of the transform of one actor in the frame. The pointer is valid during the broadcast.*/
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsChange
+{
+	AActor* Actor;
+	FTransform OldTransform;
+	FTransform NewTransform;
+};
+
+/*Native event with all changes of the frame.*/
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTransformationActorsChanged, const TArray<FTransformationActorsChange>&);
+
+/*
+Actors changed by the component in the current frame.
+The changes are collected once per frame into one packed array, the new transform is read at that moment.
+The old transform is the transform of the last collected change of the actor, or the transform remembered by Seed() before its first change.
+An actor changed without Seed() and without a previous change reports its new transform as the old one.
+Must be used only in the game thread.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsChangeTracker
+{
+public:
+
+	/*Remember the transform of the actor before a change, if it is not known yet.*/
+	void Seed(AActor* Actor);
+	void Seed(const TArray<AActor*>& Actors);
+
+	/*The actor is changed in this frame.*/
+	void MarkChanged(AActor* Actor);
+	void MarkChanged(const TArray<AActor*>& Actors);
+
+	bool HasChanges() const { return ChangedActors.Num() > 0; }
+
+	/*
+	Collect the changes of the frame into OutChanges and the box around the new locations into OutBounds.
+	The actors whose transform is the same as the old one are skipped.
+	*/
+	void Collect(TArray<FTransformationActorsChange>& OutChanges, FBox& OutBounds);
+
+	/*Forget the known transforms of the actors for which IsKept returns false. Called after Collect(), so no change of the forgotten actors is lost.*/
+	void Retain(TFunctionRef<bool(AActor*)> IsKept);
+
+	/*Forget the known transforms and the changes.*/
+	void Empty();
+
+private:
+
+	/*Transforms of the actors after their last collected change.*/
+	TMap<TWeakObjectPtr<AActor>, FTransform> KnownTransforms;
+
+	/*Actors changed in this frame, in the order of the first change.*/
+	TArray<TWeakObjectPtr<AActor>> ChangedActors;
+	TSet<TWeakObjectPtr<AActor>> ChangedActorSet;
+};
@@ -0,0 +1,87 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/ThreadSafeBool.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+
+/*Transform of one actor pushed to the command queue.*/
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsCommand
+{
+	TWeakObjectPtr<AActor> Actor;
+
+	/*
+	The new transform of the actor, or the change if bIsRelative is true:
+	the location is added, the rotation is applied in world space around the actor and the scale multiplies the scale of the actor.
+	*/
+	FTransform Transform;
+	bool bIsRelative;
+};
+
+/*All commands of one actor taken from the queue, merged into one transform.*/
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsMergedCommand
+{
+	FTransformationActorsMergedCommand();
+
+	/*Add the next command of the actor.*/
+	void Merge(const FTransformationActorsCommand& Command);
+
+	/*Transform of the actor after the commands, from its current transform.*/
+	FTransform Resolve(const FTransform& CurrentTransform) const;
+
+	TWeakObjectPtr<AActor> Actor;
+
+	/*The last absolute transform. The changes are applied on top of it, or of the current transform if there is none.*/
+	bool bHasTransform;
+	FTransform Transform;
+
+	/*Changes after the last absolute transform.*/
+	FVector DeltaLocation;
+	FQuat DeltaRotation;
+	FVector ScaleRatio;
+
+	int32 NumCommands;
+};
+
+/*
+Multi-producer queue of the transform commands.
+Any thread can push, the owning component drains the queue in the game thread once per frame and merges the commands of each actor,
+so the redundant moves of one actor cost one SetActorTransform. The queue is lock free, the producers hold it by a thread safe shared reference.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsCommandQueue : public TSharedFromThis<FTransformationActorsCommandQueue, ESPMode::ThreadSafe>
+{
+public:
+
+	FTransformationActorsCommandQueue();
+
+	/*Push the command. Can be called from any thread.*/
+	void Push(AActor* Actor, const FTransform& Transform, bool bIsRelative);
+
+	/*
+	Take up to MaxCommands commands and merge them by actor into OutCommands, in the order of the first command of each actor.
+	Return the number of the taken commands. Must be called only in the game thread.
+	*/
+	int32 Drain(int32 MaxCommands, TArray<FTransformationActorsMergedCommand>& OutCommands);
+
+	/*Are there commands in the queue. Must be called only in the game thread.*/
+	bool HasCommands() const { return !Queue.IsEmpty(); }
+
+	/*Function called in the game thread when a command is pushed. Set by the owner before the queue is shared.*/
+	void SetWakeFunction(TFunction<void()>&& InWakeFunction) { WakeFunction = MoveTemp(InWakeFunction); }
+
+private:
+
+	TQueue<FTransformationActorsCommand, EQueueMode::Mpsc> Queue;
+
+	TFunction<void()> WakeFunction;
+
+	/*The call of WakeFunction is scheduled and not done yet, the next pushes don't schedule it again.*/
+	FThreadSafeBool bIsWakeScheduled;
+
+	/*Index of the actor in OutCommands of the current Drain().*/
+	TMap<TWeakObjectPtr<AActor>, int32> MergedIndexByActor;
+};
@@ -5,11 +5,34 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Components/SceneComponent.h"
+#include "WorldCollision.h"
+#include "TransformationActorsSelection.h"
+#include "TransformationActorsHistory.h"
+#include "TransformationActorsNet.h"
+#include "TransformationActorsSnapshot.h"
+#include "TransformationActorsSnapping.h"
+#include "TransformationActorsSmoothing.h"
+#include "TransformationActorsSurfacePlacement.h"
+#include "TransformationActorsCommandQueue.h"
+#include "TransformationActorsChanges.h"
+#include "TransformationActorsMovement.h"
+#include "TransformationActorsPlayerSession.h"
 #include "TransformationActorsComponent.generated.h"
 
 
 class APlayerController;
 class APawn;
+class AController;
+class AGameModeBase;
+class FTransformationActorsRawMouseInput;
+class ATransformationActorsInstanceProxy;
+class ATransformationActorsDragProxy;
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+class UPrimitiveComponent;
+class AVolume;
+struct FTransformationActorsValidationRequest;
+struct FConvexVolume;
 
 /*The states of the actor through which you can select an operation on it.*/
 UENUM(BlueprintType, Category = "TransformationActorsComponent | ETransformState")
@@ -37,6 +60,40 @@ enum class ETransformState : uint8
 	ETS_Idle				UMETA(DisplayName = "Idle")
 };
 
+/*How the translation is swept when bSweep is true.*/
+UENUM(BlueprintType, Category = "TransformationActorsComponent | ETransformSweepMode")
+enum class ETransformSweepMode : uint8
+{
+	//Every update is a full swept move of all actors.
+	ETSM_Continuous		UMETA(DisplayName = "Continuous"),
+
+	//The actors move without the sweep during the drag. On release each actor is swept from its start location to its final location.
+	//The keyboard moves outside the drag are swept directly.
+	ETSM_OnRelease		UMETA(DisplayName = "OnRelease"),
+
+	//During the drag TransformActor is swept as a box of its bounds, the selected actors follow it without the sweep.
+	ETSM_BoundsProxy	UMETA(DisplayName = "BoundsProxy"),
+
+	//The move of TransformActor is split into full sweeps not longer than the smallest half extent of its root primitive,
+	//until SweepTimeBudgetMs is spent. The rest of the move is done in the next updates.
+	ETSM_Substepped		UMETA(DisplayName = "Substepped")
+};
+
+/*When the selected actors are dragged as the cheap proxies.*/
+UENUM(BlueprintType, Category = "TransformationActorsComponent | ETransformDragProxyMode")
+enum class ETransformDragProxyMode : uint8
+{
+	//The actors are always moved themselves.
+	ETDPM_Off		UMETA(DisplayName = "Off"),
+
+	//Every selected actor is dragged as a proxy.
+	ETDPM_Always	UMETA(DisplayName = "Always"),
+
+	//The actor is dragged as a proxy if its measured move cost is above DragProxyCostThresholdMs,
+	//or, before the first measure, if its estimated component cost is above DragProxyComponentCostThreshold.
+	ETDPM_Auto		UMETA(DisplayName = "Auto")
+};
+
 /*Dispatcher that is called when the transformation mode is activated.*/
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSwitchOnTransformationMode);
 /*Dispatcher that is called when the transformation mode is switched off.*/
@@ -45,6 +102,14 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSwitchOffTransformationMode);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnStartTransformationActor);
 /*Dispatcher called before stopping the transformation timers.*/
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnStopTransformationActor);
+/*Dispatcher called when all async picks of the batch are finished. FoundActors correspond to the requested screen positions, nullptr if nothing is found.*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAsyncPickBatchCompleted, const TArray<AActor*>&, FoundActors);
+/*Dispatcher called when the snapshot is restored. NumMissingActors is the number of the records whose actors were not found.*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSnapshotRestored, int32, NumRestoredActors, int32, NumMissingActors);
+/*Dispatcher called on the owning client when the server rejects the transforms of the session or answers its final transforms.*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnServerValidationResult, bool, bIsAccepted);
+/*Dispatcher called once per frame when the component has changed the transforms of the actors. ChangedBounds is the box around their new locations.*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnActorsChangedSummary, int32, NumChangedActors, FBox, ChangedBounds);
 
 /*Class of the main plugin component.*/
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
@@ -52,6 +117,9 @@ class TRANSFORMATIONACTORSPLUGIN_API UTransformationActorsComponent : public UAc
 {
 	GENERATED_BODY()
 
+	/*The validator sends the results of the requests.*/
+	friend class FTransformationActorsValidator;
+
 public:
 	// Sets default values for this component's properties
 	UTransformationActorsComponent();
@@ -73,6 +141,21 @@ public:
 	/*Dispatcher called before stopping the transformation timers.*/
 	UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "TransformationActorsComponent | Delegates")
 		FOnStopTransformationActor OnStopTransformationActor;
+	/*Dispatcher called when all async picks of the batch are finished.*/
+	UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "TransformationActorsComponent | Delegates")
+		FOnAsyncPickBatchCompleted OnAsyncPickBatchCompleted;
+	/*Dispatcher called when the snapshot is restored.*/
+	UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "TransformationActorsComponent | Delegates")
+		FOnSnapshotRestored OnSnapshotRestored;
+	/*Dispatcher called on the owning client when the server rejects the transforms of the session or answers its final transforms.*/
+	UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "TransformationActorsComponent | Delegates")
+		FOnServerValidationResult OnServerValidationResult;
+	/*Dispatcher called once per frame with the number of the actors changed by the component.*/
+	UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "TransformationActorsComponent | Delegates")
+		FOnActorsChangedSummary OnActorsChangedSummary;
+
+	/*Native event called once per frame with the old and the new transforms of all actors changed by the component in the frame.*/
+	FOnTransformationActorsChanged OnActorsChanged;
 
 	/*The period when the timer for translation actors is triggered.*/
 	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
@@ -86,18 +169,93 @@ public:
 	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
 		float ScaleTimerDeltaTime;
 
+	/*If true than LocationActor(), RotationActor() and ScaleActor() are called from the component tick once per frame with the real frame time instead of the timers.
+	The tick is switched off when there is no transformation.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
+		bool bUseTickInsteadOfTimers;
+
+	/*If true than RotationActor() and ScaleActor() take the mouse deltas accumulated by a Slate input preprocessor instead of polling the cursor position.
+	The updates are done in the component tick as soon as the mouse moves, and are skipped while the mouse is still.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
+		bool bUseRawMouseInput;
+
 	/*Parameter for VInterpConstantTo, interpolation speed of translation vector.*/
 	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
 		float LocationSpeed;
 
+	/*How TransformActor follows the cursor.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
+		ELocationSmoothingMode LocationSmoothingMode;
+
+	/*Time constant of the CriticallyDamped smoothing in seconds. The actor trails the cursor by the distance the cursor moves in this time.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent", meta = (ClampMin = "0.001"))
+		float LocationSmoothingTime;
+
+	/*The CriticallyDamped smoothing aims ahead of the cursor by its velocity multiplied by this time. Equal to LocationSmoothingTime removes the trailing.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent", meta = (ClampMin = "0"))
+		float LocationPredictionTime;
+
 	/*If true than actor under cursor or keyboard can't move through other objects . If false than actor can do it*/
 	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
 		bool bSweep;
 
+	/*How the translation is swept when bSweep is true.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
+		ETransformSweepMode SweepMode;
+
+	/*Time in milliseconds that the substepped sweeps of TransformActor may take in one update.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent", meta = (ClampMin = "0.01"))
+		float SweepTimeBudgetMs;
+
 	/*The speed of translation in depth (from yourself or to yourself).*/
 	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
 		float LocationDeepSpeed;
 
+	/*If true than LocationActor() traces the cursor ray against the world, ignoring the selected actors, and puts the bounds of TransformActor on the hit surface.
+	The depth input raises the actor above the surface. Without a surface under the cursor the actor moves at the saved distance along the ray.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Surface")
+		bool bPlaceOnSurface;
+
+	/*If true than the actor placed on the surface is turned so its up axis is the surface normal.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Surface")
+		bool bAlignToSurfaceNormal;
+
+	/*Channel of the surface traces.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Surface")
+		TEnumAsByte<ECollisionChannel> SurfaceTraceChannel;
+
+	/*If not Off than the heavy selected actors stay in place during the transformation, their proxies are transformed instead.
+	Each actor is moved once to the transform of its proxy by StopTransformationActor(). Not used by the replicated sessions.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | DragProxy")
+		ETransformDragProxyMode DragProxyMode;
+
+	/*Time in milliseconds of one move of the actor above which the Auto mode drags it as a proxy.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | DragProxy", meta = (ClampMin = "0"))
+		float DragProxyCostThresholdMs;
+
+	/*Estimated component cost of the actor not measured yet above which the Auto mode drags it as a proxy.
+	A scene component costs 1, a primitive with the overlap events 2, a light 4, a skeletal mesh 8.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | DragProxy", meta = (ClampMin = "1"))
+		int32 DragProxyComponentCostThreshold;
+
+	/*Simplified mesh of the proxy, fitted into the bounds of the actor. If not set, the proxy is the box of the bounds.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | DragProxy")
+		UStaticMesh* DragProxyMesh;
+
+	/*If true than the moves of TransformActor and the selected actors in one update are batched:
+	the attached components, the physics bodies and the overlaps of each actor are updated once at the end of the update.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Movement")
+		bool bBatchDragMovement;
+
+	/*If true than the overlaps and the physics volumes of the transformed actors are not updated by their moves.
+	They are updated once at the end of the transformation and every DragOverlapUpdateInterval seconds.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Movement")
+		bool bDeferDragOverlaps;
+
+	/*Interval in seconds of the overlap updates during the transformation when bDeferDragOverlaps is true. 0 - only at the end of the transformation.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Movement", meta = (ClampMin = "0"))
+		float DragOverlapUpdateInterval;
+
 	/*Scaling speed.*/
 	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent")
 		float ScaleSpeed;
@@ -125,6 +283,130 @@ public:
 	/*Speed of scale actor with keyboard.*/
 	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Keyboard")
 		float ScaleSpeedKeyboard;
+
+	/*If true than the keyboard axes only add to the pending deltas, and the deltas of all axes are applied once per frame in the component tick,
+	scaled by the frame time. The keyboard speeds are then the speeds per frame at 60 FPS.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Keyboard")
+		bool bCoalesceKeyboardInput;
+
+	/*If true than a click on a new actor adds it to the selected actors. If false than the new actor replaces the selected actors.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Selection")
+		bool bIsAdditiveSelection;
+
+	/*If true than FindActorUnderCursor() tests the cursor ray against the spatial index of the actors with TransformationActorsInterface and their simple collision
+	instead of the complex trace against the whole scene.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Picking")
+		bool bUseSpatialIndexPicking;
+
+	/*If true than the actor found in the spatial index is rejected when another object blocks the cursor ray before it.
+	Off by default: the test is one more scene trace per pick, which costs as much as the picking without the index. Enable it if the actors can be hidden behind the level.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Picking")
+		bool bTestPickingOcclusion;
+
+	/*If true than StartTransformationActor() does not block the game thread with the trace under the cursor.
+	The trace is done by the async trace of the world and the selection is finished in the next frame.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Picking")
+		bool bUseAsyncPicking;
+
+	/*If true than a click on an instance of an instanced static mesh component (ISM or HISM) selects and transforms the instance instead of the whole actor.
+	The instance is represented by a transient proxy actor, the instances are updated once per frame.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Picking")
+		bool bPickInstances;
+
+	/*If true than each transformation session is written to the undo history.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | History")
+		bool bIsHistoryEnabled;
+
+	/*Maximum number of records in the undo history. One record is the change of one actor, it takes about 40 bytes.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | History", meta = (ClampMin = "1"))
+		int32 MaxHistoryRecords;
+
+	/*If true than the transformation sessions are replicated: the owning client sends the quantized delta of the controlled actor to the server
+	at NetUpdateRate, the server applies it and relays it to the other clients, which interpolate toward it. The final transforms are sent reliably on stop.
+	The component must be on the Pawn possessed by the player: the server RPCs need the actor owned by the player connection,
+	and the multicasts need the actor relevant to the other clients. A PlayerController exists only on its owning client, so it can't relay the session.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Replication")
+		bool bIsReplicateTransformation;
+
+	/*Maximum number of the network updates of the transformation session per second.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Replication", meta = (ClampMin = "1", ClampMax = "60"))
+		float NetUpdateRate;
+
+	/*Speed of the interpolation of the remote sessions on the clients. 0 - no interpolation.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Replication", meta = (ClampMin = "0"))
+		float NetInterpolationSpeed;
+
+	/*If true than the server tests the transforms received from the client against the placement rules before it applies and relays them.
+	The rejected updates are not applied, the owner gets the transforms of the last accepted update as the corrections.
+	The requests of all players are tested in one queue within ValidationTestsPerFrame and ValidationBudgetMs.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation")
+		bool bIsServerValidationEnabled;
+
+	/*Maximum number of the validated updates of one player per second. The updates above the rate are dropped.
+	The final transforms are always validated, but they take from the same rate, so the following sessions wait for it.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation", meta = (ClampMin = "1"))
+		float ValidationRequestRate;
+
+	/*Maximum distance of an actor from the location last accepted by the server, i.e. the move of one validated update.
+	Together with ValidationRequestRate it limits the speed of the actors, also across the sessions. 0 - no limit.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation", meta = (ClampMin = "0"))
+		float ValidationMaxDistance;
+
+	/*If true than the bounds of the actors at the new transforms must not overlap the objects that block ValidationOverlapChannel.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation")
+		bool bTestValidationOverlap;
+
+	/*Channel of the overlap test.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation")
+		TEnumAsByte<ECollisionChannel> ValidationOverlapChannel;
+
+	/*The actors must stay inside one of the volumes. Empty - no limit.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation")
+		TArray<AVolume*> ValidationVolumes;
+
+	/*Maximum number of the actor tests of all players in one frame on the server.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation", meta = (ClampMin = "1"))
+		int32 ValidationTestsPerFrame;
+
+	/*Time in milliseconds that the validation of all players may take in one frame on the server.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Validation", meta = (ClampMin = "0.1"))
+		float ValidationBudgetMs;
+
+	/*Time in milliseconds that the restore of the snapshot may take in one frame.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapshot", meta = (ClampMin = "0.1"))
+		float SnapshotRestoreBudgetMs;
+
+	/*Maximum number of the queued transform commands applied in one frame. The rest are applied in the next frames.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Commands", meta = (ClampMin = "1"))
+		int32 CommandsPerFrame;
+
+	/*If true than the location of TransformActor is snapped to the grid.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapping")
+		bool bIsLocationSnapEnabled;
+
+	/*Size of the location grid.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapping", meta = (ClampMin = "0.01"))
+		float LocationSnapGrid;
+
+	/*If true than the rotation of TransformActor is snapped to the angle step.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapping")
+		bool bIsRotationSnapEnabled;
+
+	/*Angle step in degrees.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapping", meta = (ClampMin = "0.01"))
+		float RotationSnapStep;
+
+	/*If true than the scale of TransformActor is snapped to the scale step.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapping")
+		bool bIsScaleSnapEnabled;
+
+	/*Scale step.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapping", meta = (ClampMin = "0.001"))
+		float ScaleSnapStep;
+
+	/*Space of the location grid and the rotation steps.*/
+	UPROPERTY(EditAnywhere, Category = "TransformationActorsComponent | Snapping")
+		ETransformationSnapSpace SnapSpace;
 private:
 	//////////////////////////////////////////////////////////////////////////
 	/*Private variables.*/
@@ -145,22 +427,160 @@ private:
 	/*Lock the actions in the first tick of the ScaleTimer.*/
 	bool bIsLockFirstIterationScaleTimer;
 
+	/*Translation is updated in the component tick instead of LocationTimer.*/
+	bool bIsLocationTickActive;
+	/*Rotation is updated in the component tick instead of RotationTimer.*/
+	bool bIsRotationTickActive;
+	/*Scale is updated in the component tick instead of ScaleTimer.*/
+	bool bIsScaleTickActive;
+
+	/*Preprocessor of the mouse deltas while the rotation or the scale of the active player uses the raw mouse input.
+	The preprocessors of the other players are kept in their sessions.*/
+	TSharedPtr<FTransformationActorsRawMouseInput> RawMouseInput;
+
+	/*Transform commands of the other threads and their merged batch of the frame.*/
+	TSharedPtr<FTransformationActorsCommandQueue, ESPMode::ThreadSafe> CommandQueue;
+	TArray<FTransformationActorsMergedCommand> MergedCommands;
+	/*Cursor position of the active player made of the raw deltas since the start of the rotation or the scale.*/
+	FVector2D RawMouseCursor;
+
+	/*DeltaSeconds of the last component tick.*/
+	float TickDeltaTime;
+
+	/*States of the players other than the active one. The state of the active player is in the members of the component.*/
+	TArray<FTransformationActorsPlayerSession> PlayerSessions;
+
+	/*The cursor of the player is set by SetPlayerCursorPosition() instead of the mouse.*/
+	bool bUseVirtualCursor;
+	FVector2D VirtualCursor;
+	/*The world ray of the cursor is set by SetPlayerCursorRay() instead of the deprojection. The remote players have no viewport to deproject.*/
+	bool bUseCursorRay;
+	FVector CursorRayOrigin;
+	FVector CursorRayDirection;
+
+	/*Box selection started by BeginMarqueeSelection() at MarqueeStart.*/
+	bool bIsMarqueeSelection;
+	FVector2D MarqueeStart;
+
+	/*Async trace under the cursor started by StartTransformationActor().*/
+	FTraceHandle CursorPickTraceHandle;
+	FTraceDelegate CursorPickTraceDelegate;
+	/*The async trace under the cursor is not finished.*/
+	bool bIsCursorPickPending;
+	/*StopTransformationActor() was called before the async trace under the cursor was finished.*/
+	bool bIsStopRequestedDuringPick;
+
+	/*Screen positions for the next batch of async picks.*/
+	TArray<FVector2D> PickRequests;
+	/*Async traces of the current batch.*/
+	TArray<FTraceHandle> BatchPickTraceHandles;
+	FTraceDelegate BatchPickTraceDelegate;
+	/*Results of the current batch.*/
+	TArray<TWeakObjectPtr<AActor>> BatchPickResults;
+	/*Number of the unfinished traces of the current batch.*/
+	int32 NumBatchPickTracesPending;
+
+	/*Keyboard input of the frame when bCoalesceKeyboardInput is true: the location in the space of the axis component,
+	the angles around the roll, pitch and yaw axes in degrees and the scale, not scaled by the frame time yet.*/
+	FVector PendingKeyboardLocation;
+	FVector PendingKeyboardRotation;
+	FVector PendingKeyboardScale3D;
+	bool bIsKeyboardCommitPending;
+
+	/*Component and item of the last hit under the cursor, for the instance picking.*/
+	TWeakObjectPtr<UPrimitiveComponent> PickedComponent;
+	int32 PickedItem;
+
+	/*Proxies of the picked instances.*/
+	TArray<TWeakObjectPtr<ATransformationActorsInstanceProxy>> InstanceProxies;
+	/*Proxies moved since the last write to the instances.*/
+	TArray<TWeakObjectPtr<ATransformationActorsInstanceProxy>> PendingInstanceProxies;
+	/*Components of the instances written in the frame. Kept between the frames to avoid the allocations.*/
+	TArray<UInstancedStaticMeshComponent*> DirtyInstanceComponents;
+
+	/*Proxies dragged instead of the selected actors.*/
+	TArray<TWeakObjectPtr<ATransformationActorsDragProxy>> DragProxies;
+	/*Released proxies of all players, hidden until the next drag.*/
+	TArray<TWeakObjectPtr<ATransformationActorsDragProxy>> DragProxyPool;
+	/*Measured time in milliseconds of one move of the actor.*/
+	TMap<TWeakObjectPtr<AActor>, float> MoveCostMsByActor;
+
+	/*Overlaps of the transformed actors held back by bDeferDragOverlaps.*/
+	FTransformationActorsOverlapDeferral OverlapDeferral;
+
 	/*The states of the actor through which you can select an operation on it.*/
 	ETransformState TransformState;
 
 	/*Saves the state of the actors: under the control of the player cursor or not.*/
 	bool bIsTransform;
 
-	APlayerController* PlayerController;
-	APawn* PlayerPawn;
+	/*The objects of the player are not referenced by the component, they can be destroyed with the player.*/
+	TWeakObjectPtr<APlayerController> PlayerController;
+	TWeakObjectPtr<APawn> PlayerPawn;
 
 	/*The component from which the axes of transformation are taken.*/
-	USceneComponent* ComponentForTransformationAxis;
+	TWeakObjectPtr<USceneComponent> ComponentForTransformationAxis;
 
 	/*An actor controlled by a player.*/
-	AActor* TransformActor;
+	TWeakObjectPtr<AActor> TransformActor;
 	/*The actor controlled by the player the previous time.*/
-	AActor* PreviousTransformActor;
+	TWeakObjectPtr<AActor> PreviousTransformActor;
+
+	/*Selected actors. TransformActor is driven by the cursor or keyboard, the rest of the actors follow it with the same delta.*/
+	FTransformationActorsSelection Selection;
+
+	/*Undo and redo history of the transformations.*/
+	FTransformationActorsHistory History;
+
+	/*Replicated transformation session. On the owner it predicts the actors for the corrections, on the server and the remote clients it drives the actors.*/
+	FTransformationActorsNetSession NetSession;
+	/*This machine started the replicated session.*/
+	bool bIsNetSessionOwner;
+	/*The player whose transformation is replicated. One replicated session runs at a time.*/
+	TWeakObjectPtr<APlayerController> NetSessionController;
+	/*The remote session is interpolated in the component tick.*/
+	bool bIsNetInterpolationActive;
+	/*Time of the last network update of the session.*/
+	float LastNetUpdateTime;
+	/*The last sent delta. The update is not sent if the delta is the same.*/
+	FTransformationActorsNetDelta LastNetDelta;
+
+	/*Token bucket of the validated updates on the server: the tokens and the time of the last refill.*/
+	float NetRequestTokens;
+	float LastNetRequestTime;
+	/*The requests of the component are in the queue of the validator.*/
+	bool bIsNetValidationPending;
+	/*The last delta accepted by the server. The rejected requests are corrected to it.*/
+	FTransformationActorsNetDelta LastAcceptedNetDelta;
+	/*The corrections of a rejected update are sent. The next rejections are not sent until an update is accepted.*/
+	bool bIsNetCorrectionSent;
+
+	/*Actors transformed by this component. They are written to the snapshot.*/
+	TSet<TWeakObjectPtr<AActor>> ModifiedActors;
+
+	/*Actors changed in the frame for OnActorsChanged and their collected changes.*/
+	FTransformationActorsChangeTracker ChangeTracker;
+	TArray<FTransformationActorsChange> FrameChanges;
+
+	/*Time sliced restore of the snapshot.*/
+	FTransformationActorsSnapshot Snapshot;
+
+	/*Snap kernels selected for the current update.*/
+	FTransformationActorsSnapper Snapper;
+	/*Unsnapped transform of TransformActor. The input is accumulated in it, so small steps are not lost by the snapping.*/
+	FTransform SnapRawTransform;
+	/*The snapped transform set to SnapActor. If the actor has another transform, it was moved outside and the raw transform is reset.*/
+	FTransform SnapAppliedTransform;
+	TWeakObjectPtr<AActor> SnapActor;
+
+	/*Spring of the CriticallyDamped location smoothing.*/
+	FTransformationActorsLocationSpring LocationSpring;
+	/*World time of the previous LocationActor() call.*/
+	float LastLocationUpdateTime;
+
+	/*Surface under the cursor for bPlaceOnSurface.*/
+	FTransformationActorsSurfacePlacement SurfacePlacement;
+	FTraceDelegate SurfaceTraceDelegate;
 
 	/*Memorized rotations from the previous CalcDelta...() method call.*/
 	/*Вращение вокруг оси Х в градусах.*/
@@ -299,6 +719,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Basic methods")
 		AActor* FindActorUnderCursor();
 
+	/*Select or start to transform the actor found under the cursor. The second part of StartTransformationActor().*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Basic methods")
+		void StartTransformationFoundActor(AActor* FoundActor);
+
+	/*Start the async trace under the cursor. StartTransformationFoundActor() is called with the result in the next frame.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		bool StartAsyncPickUnderCursor();
+
+	/*Add the screen position to the next batch of async picks. All positions added in one frame are traced together, the result comes to OnAsyncPickBatchCompleted.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		void AddAsyncPickRequest(FVector2D ScreenPosition);
+
 	/*Run
 	StartLocationTimer() or
 	StartRotationTimer() or
@@ -348,6 +780,97 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Basic methods")
 		void SelectNewTransformActor(AActor* NewTransformActor);
 
+	/*Add the actor to the selected actors. The actor must implement TransformationActorsInterface.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		bool AddActorToSelection(AActor* Actor);
+
+	/*Remove the actor from the selected actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		bool RemoveActorFromSelection(AActor* Actor);
+
+	/*Remove all actors from the selected actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		void ClearSelection();
+
+	/*Is the actor in the selected actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		bool IsActorSelected(AActor* Actor) const;
+
+	/*Get all selected actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		TArray<AActor*> GetSelectedActors() const;
+
+	/*Number of the selected actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		int32 GetNumSelectedActors() const { return Selection.Num(); }
+
+	/*Select the actors whose bounds intersect the frustum of the screen rectangle. If bAddToSelection is false than the rectangle replaces the selected actors.
+	Return the number of the added actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		int32 SelectActorsInScreenRect(FVector2D ScreenStart, FVector2D ScreenEnd, bool bAddToSelection);
+
+	/*Start the box selection at the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		void BeginMarqueeSelection();
+
+	/*Select the actors in the rectangle from the start of the box selection to the cursor. Return the number of the added actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		int32 EndMarqueeSelection(bool bAddToSelection);
+
+	/*Rectangle of the box selection in progress, to draw it. Return false if there is no box selection.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		bool GetMarqueeSelectionRect(FVector2D& OutStart, FVector2D& OutEnd);
+
+	/*Revert the last transformation.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		bool UndoTransformation();
+
+	/*Apply the last reverted transformation again.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		bool RedoTransformation();
+
+	/*Start to write the changes of the selected actors to the undo history. Use it to wrap keyboard or batch operations in one entry.
+	Transformation sessions started by StartTransformationActor() are written automatically.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		void BeginHistoryTransaction();
+
+	/*Finish the entry started by BeginHistoryTransaction(). Return false if nothing has changed.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		bool EndHistoryTransaction();
+
+	/*Remove all entries of the undo history.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		void ClearHistory();
+
+	/*Write the transforms of the modified actors to the binary file. A relative FileName is resolved in the Saved directory of the project.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		bool SaveTransformationSnapshot(const FString& FileName);
+
+	/*Start to apply the transforms from the binary file. The records are applied in the component tick within SnapshotRestoreBudgetMs per frame,
+	OnSnapshotRestored is called at the end, the change events report the actors of each frame. Return false if the file is missing or has another format.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		bool RestoreTransformationSnapshot(const FString& FileName);
+
+	/*Stop the restore of the snapshot. The applied records are kept.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		void CancelTransformationSnapshotRestore();
+
+	/*Actors transformed by this component since the start or the last ClearModifiedActors().*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		TArray<AActor*> GetModifiedActors() const;
+
+	/*Forget the modified actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		void ClearModifiedActors() { ModifiedActors.Reset(); }
+
+	/*Queue the transform of the actor. It is applied in the component tick with the interface notifications, MinScale and the undo record.
+	If bIsRelative is true than Transform is the change: the location is added, the rotation is applied around the actor and the scale multiplies its scale.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Commands")
+		void QueueTransformCommand(AActor* Actor, FTransform Transform, bool bIsRelative);
+
+	/*Queue of the transform commands. Any thread can keep the reference and push to it.*/
+	TSharedRef<FTransformationActorsCommandQueue, ESPMode::ThreadSafe> GetCommandQueue() const { return CommandQueue.ToSharedRef(); }
+
 	/*Call the TransformationActorsInterface method.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Basic methods")
 		void HighlightOn_TransformationActorsInterface(AActor* Actor);
@@ -391,6 +914,38 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Basic methods")
 		bool CheckControllerAndPawn();
 
+	/*Make the player the active one: the next calls of the component methods are done for this player, with its own state, selection and cursor.
+	The state is created on the first call for the player. The updates of all players run in the component tick.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Players")
+		bool ActivatePlayerSession(APlayerController* InPlayerController);
+
+	/*Stop the transformation of the player and remove its state.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Players")
+		void RemovePlayerSession(APlayerController* InPlayerController);
+
+	/*Controllers of all players that have a state in the component. The active player is the first one.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Players")
+		TArray<APlayerController*> GetPlayerSessionControllers() const;
+
+	/*Use the screen position as the cursor of the player instead of the mouse, e.g. for the gamepads in split-screen. Return false if the player has no state.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Players")
+		bool SetPlayerCursorPosition(APlayerController* InPlayerController, FVector2D ScreenPosition);
+
+	/*Use the world ray as the cursor ray of the player instead of the deprojection of the screen cursor.
+	Needed by the remote players on the server: they have no viewport, so only the ray picking and the translation work without it.
+	The box selection and the batch picks by the screen positions work only for the local players. Return false if the player has no state.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Players")
+		bool SetPlayerCursorRay(APlayerController* InPlayerController, FVector RayOrigin, FVector RayDirection);
+
+	/*Use the mouse as the cursor of the player again.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Players")
+		void ReleasePlayerCursor(APlayerController* InPlayerController);
+
+	/*Send the cursor of the local player of the owning client to the server, for the session of this player on the server.
+	Call it every frame while the server transforms the actors for this client. Return false if the cursor is not available.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Players")
+		bool SendCursorToServer();
+
 
 
 
@@ -401,6 +956,233 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the game ends or when destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Called every frame while the tick is switched on
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/*Switch the component tick on if there are updates in the tick, otherwise switch it off.*/
+	void UpdateComponentTickEnabled();
+
+	/*Run the tick updates of the active player.*/
+	void TickPlayerSession(float DeltaTime);
+
+	/*The updates run in the component tick: bUseTickInsteadOfTimers is true or there are several players.*/
+	bool IsUpdateInTick() const { return bUseTickInsteadOfTimers || PlayerSessions.Num() > 0; }
+
+	/*Move the running timer updates of the active player to the tick. The timers always update the active player.*/
+	void SwitchTimersToTick();
+
+	/*Exchange the state of the active player with the stored state.*/
+	void SwapPlayerSession(FTransformationActorsPlayerSession& Session);
+
+	/*Stored state of the player, nullptr if the player is active or has no state.*/
+	FTransformationActorsPlayerSession* FindPlayerSession(APlayerController* InPlayerController);
+
+	/*Drop the states of the destroyed players, the active one included.*/
+	void PrunePlayerSessions();
+
+	/*Release the drag proxies and the held back overlaps of the dropped state. The actors stay where they are.*/
+	void ReleasePlayerSession(FTransformationActorsPlayerSession& Session);
+
+	/*The player left the game.*/
+	void OnGameModeLogout(AGameModeBase* GameMode, AController* Exiting);
+
+	UFUNCTION()
+		void OnPlayerControllerDestroyed(AActor* DestroyedActor);
+
+	FDelegateHandle GameModeLogoutHandle;
+
+	/*Start the async traces for PickRequests.*/
+	void FlushAsyncPickRequests();
+
+	/*Result of the async trace under the cursor.*/
+	void OnCursorPickTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/*Result of one async trace of the batch.*/
+	void OnBatchPickTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/*Result of the async surface trace of bPlaceOnSurface.*/
+	void OnSurfaceTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/*Is the transformation session replicated in the current net mode.*/
+	bool IsNetSessionReplicated() const;
+
+	/*Start the replicated session for the selected actors.*/
+	void BeginNetSession();
+
+	/*Send the delta of TransformActor if the update interval has passed.*/
+	void UpdateNetSession();
+
+	/*Send the final delta and the corrections reliably.*/
+	void EndNetSession();
+
+	/*Owner to server.*/
+	UFUNCTION(Server, Reliable, WithValidation)
+		void ServerBeginNetSession(const TArray<AActor*>& Actors, AActor* PivotActor);
+	UFUNCTION(Server, Unreliable, WithValidation)
+		void ServerUpdateNetSession(const FTransformationActorsNetDelta& Delta);
+	UFUNCTION(Server, Reliable, WithValidation)
+		void ServerEndNetSession(const FTransformationActorsNetDelta& Delta, const TArray<FTransformationActorsNetTransform>& Corrections);
+	/*The cursor of the owning client for its session on the server.*/
+	UFUNCTION(Server, Unreliable, WithValidation)
+		void ServerSetPlayerCursor(FVector2D ScreenPosition, FVector RayOrigin, FVector RayDirection);
+
+	/*Server to the other clients.*/
+	UFUNCTION(NetMulticast, Reliable)
+		void MulticastBeginNetSession(const TArray<AActor*>& Actors, AActor* PivotActor);
+	UFUNCTION(NetMulticast, Unreliable)
+		void MulticastUpdateNetSession(const FTransformationActorsNetDelta& Delta);
+	UFUNCTION(NetMulticast, Reliable)
+		void MulticastEndNetSession(const FTransformationActorsNetDelta& Delta, const TArray<FTransformationActorsNetTransform>& Corrections);
+
+	/*Server to the owner: the result of the validation and the transforms of the actors if the request is rejected.*/
+	UFUNCTION(Client, Reliable)
+		void ClientNetSessionValidated(bool bIsAccepted, const TArray<FTransformationActorsNetTransform>& Corrections);
+
+	/*The multicast is executed on this machine by a session started by another machine.*/
+	bool IsRemoteNetSessionReceiver() const;
+
+	/*Take a token of the rate limit of the validated updates. Return false if the update must be dropped.
+	bIsForced - the token is taken also from the empty bucket and the next updates wait for it. Return true then.*/
+	bool ConsumeNetRequestToken(bool bIsForced = false);
+
+	/*Queue the received delta of the session for the validation.*/
+	void SubmitNetRequest(const FTransformationActorsNetDelta& Delta, const TArray<FTransformationActorsNetTransform>& Corrections, bool bIsFinal);
+
+	/*Apply and relay the accepted request, correct the owner if the request is rejected.*/
+	void OnNetRequestValidated(const FTransformationActorsValidationRequest& Request, bool bIsAccepted);
+
+	/*Remember the actors for the snapshot.*/
+	void MarkActorsModified(const TArray<AActor*>& Actors);
+
+	/*Apply the queued transform commands of the frame as one undo record.*/
+	void ApplyTransformCommands();
+
+	/*Remember TransformActor and the selected actors for the snapshot.*/
+	void MarkSelectionModified();
+
+	/*Someone listens to the change events. The changes are tracked only then.*/
+	bool IsChangeEventBound() const { return OnActorsChanged.IsBound() || OnActorsChangedSummary.IsBound(); }
+
+	/*Remember the transforms of the actors before they are changed.*/
+	void SeedActorChanges(const TArray<AActor*>& Actors);
+
+	/*Does a player of the component still transform the actor: it is controlled, selected, dragged by a proxy or in the network session.*/
+	bool IsActorInUse(AActor* Actor) const;
+
+	/*Report the actors in the change events of the frame.*/
+	void MarkActorsChanged(const TArray<AActor*>& Actors);
+
+	/*Report TransformActor and the selected actors in the change events of the frame.*/
+	void MarkSelectionChanged();
+
+	/*Report the actors of the net session in the change events of the frame.*/
+	void MarkNetSessionChanged();
+
+	/*Send the changes of the frame to the listeners.*/
+	void BroadcastActorChanges();
+
+	/*Select the snap kernels for the current settings and the current space.*/
+	void UpdateSnapper();
+
+	/*Raw transform of TransformActor. Reset to the transform of the actor if the actor is changed or moved outside.*/
+	FTransform& SyncSnapRawTransform();
+
+	/*Remember the transform of TransformActor after the snapped update.*/
+	void StoreSnapAppliedTransform();
+
+	/*Move TransformActor by the delta, snapped to the location grid if it is enabled.*/
+	void AddTransformActorLocation(const FVector& DeltaLocation);
+
+	/*Rotate TransformActor by the world space delta, snapped to the angle step if it is enabled.*/
+	void AddTransformActorRotation(const FQuat& DeltaRotationQ);
+
+	/*Add the delta to the scale of TransformActor, snapped to the scale step if it is enabled. Return the change of the scale that the selected actors follow.*/
+	FVector AddTransformActorScale(const FVector& DeltaScale3D);
+
+	/*Add the keyboard input to the deltas of the frame.*/
+	void AddPendingKeyboardInput(const FVector& DeltaLocation, const FVector& DeltaRotation, const FVector& DeltaScale3D);
+
+	/*Apply the keyboard input of the frame to TransformActor and the selected actors.*/
+	void CommitKeyboardInput(float DeltaTime);
+
+	/*Every move is a full sweep: bSweep is true and SweepMode is Continuous, or OnRelease outside the transformation, where no release sweeps the moves.*/
+	bool IsContinuousSweep() const
+	{
+		return bSweep && (SweepMode == ETransformSweepMode::ETSM_Continuous || (SweepMode == ETransformSweepMode::ETSM_OnRelease && !GetIsTransform()));
+	}
+
+	/*Move TransformActor to the location with the current sweep mode.*/
+	void SetTransformActorLocation(const FVector& NewLocation);
+
+	/*Part of the delta that the box of the bounds of the actor can pass before a blocking hit.*/
+	FVector SweepBoundsProxy(AActor* Actor, const FVector& DeltaLocation) const;
+
+	/*Sweep each selected actor from its start location to its current location. Used by the OnRelease mode at the end of the transformation.*/
+	void SweepSelectionOnRelease();
+
+	/*Cursor ray in world space.*/
+	bool DeprojectCursor(FVector& OutWorldLocation, FVector& OutWorldDirection) const;
+
+	/*Remember the component and the item of the hit under the cursor.*/
+	void SetPickedHit(const FHitResult& HitResult);
+
+	/*Frustum of the screen rectangle from the camera of the player to HitResultTraceDistance.*/
+	bool MakeScreenRectFrustum(const FVector2D& ScreenStart, const FVector2D& ScreenEnd, FConvexVolume& OutFrustum) const;
+
+	/*Proxy of the picked instance if FoundActor is the owner of the picked instance and the instance picking is on, otherwise FoundActor.*/
+	AActor* ResolveInstanceProxy(AActor* FoundActor);
+
+	/*Actor that receives the interface events of Actor: the owner of the instance for an instance proxy, otherwise Actor.*/
+	AActor* GetInterfaceEventActor(AActor* Actor) const;
+
+	/*Find or spawn the proxy of the instance.*/
+	ATransformationActorsInstanceProxy* GetInstanceProxy(UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex);
+
+	/*Queue the moved proxy for the write to its instance.*/
+	void OnInstanceProxyMoved(ATransformationActorsInstanceProxy* Proxy);
+
+	/*Write the moved proxies to their instances and mark the render state of each changed component dirty once.*/
+	void FlushInstanceProxies();
+
+	/*Replace the heavy selected actors and TransformActor by the drag proxies.*/
+	void BeginDragProxies();
+
+	/*Move each actor to the transform of its proxy, put the actors back to the selection and release the proxies.*/
+	void EndDragProxies();
+
+	/*The actor is dragged as a proxy in the current DragProxyMode.*/
+	bool ShouldUseDragProxy(AActor* Actor) const;
+
+	/*Take a released proxy or spawn a new one.*/
+	ATransformationActorsDragProxy* AcquireDragProxy();
+
+	/*Remember the measured time of one move of the actor for the Auto mode.*/
+	void RecordMoveCost(AActor* Actor, float CostMs);
+
+	/*Start the moves of an update: update the held back overlaps if the interval has passed and batch the moves of TransformActor and the selected actors.*/
+	void BeginMovementUpdate(FTransformationActorsMovementBatch& MovementBatch);
+
+	/*Hold back the overlaps of TransformActor and the selected actors if bDeferDragOverlaps is true.*/
+	void PauseDragOverlaps();
+
+	/*Count TransformActor and the selected actors in the stat of the moved actors.*/
+	void AddActorsMovedStat() const;
+
+	/*Register the raw mouse input preprocessor. Return false if the raw mouse input is not used.*/
+	bool StartRawMouseInput();
+
+	/*Unregister the raw mouse input preprocessor.*/
+	void StopRawMouseInput();
+
+	/*The raw mouse input is used and the mouse has not moved since the last update.*/
+	bool IsRawMouseInputIdle() const;
+
+	/*Position of the cursor for RotationActor() and ScaleActor(): made of the raw deltas or polled from PlayerController.*/
+	bool GetCursorPosition(float& OutLocationX, float& OutLocationY);
+
 
 	//////////////////////////////////////////////////////////////////////////
 		/* BlueprintCallable getters and setters.*/
@@ -411,7 +1193,7 @@ public:
 		void SetTransformActor(AActor* InTransformActor) { TransformActor = InTransformActor; }
 	/*Get TransformActor, which is controlled by the player.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
-		AActor* GetTransformActor() const { return TransformActor; }
+		AActor* GetTransformActor() const { return TransformActor.Get(); }
 
 
 	/*Set the PreviousTransformActor that the player was controlling.*/
@@ -419,7 +1201,7 @@ public:
 		void SetPreviousTransformActor(AActor* InPreviousTransformActor) { PreviousTransformActor = InPreviousTransformActor; }
 	/*Get PreviousTransformActor, which was managed by the player.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
-		AActor* GetPreviousTransformActor() const { return PreviousTransformActor; }
+		AActor* GetPreviousTransformActor() const { return PreviousTransformActor.Get(); }
 
 
 	/*Get the state of the actor through which you can select an operation on it.*/
@@ -467,6 +1249,20 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
 		float GetScaleTimerDeltaTime() { return ScaleTimerDeltaTime; }
 
+	/*Update the transformation in the component tick instead of the timers.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetUseTickInsteadOfTimers(bool InUseTickInsteadOfTimers) { bUseTickInsteadOfTimers = InUseTickInsteadOfTimers; }
+	/*Update the transformation in the component tick instead of the timers.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		bool GetUseTickInsteadOfTimers() const { return bUseTickInsteadOfTimers; }
+
+	/*Take the mouse deltas from a Slate input preprocessor instead of polling the cursor. Applied from the next rotation or scale.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetUseRawMouseInput(bool InUseRawMouseInput) { bUseRawMouseInput = InUseRawMouseInput; }
+	/*Take the mouse deltas from a Slate input preprocessor instead of polling the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		bool GetUseRawMouseInput() const { return bUseRawMouseInput; }
+
 	/*Blocking actions in the first tick of the timer.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
 		bool GetIsLockFirstIterationLocationTimer() const { return bIsLockFirstIterationLocationTimer; }
@@ -490,7 +1286,7 @@ public:
 
 	/*Get the Player Controller you're using.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
-		APlayerController* GetPlayerController() const { return PlayerController; }
+		APlayerController* GetPlayerController() const { return PlayerController.Get(); }
 	/*Specify Player Controller for use by the component.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
 		void SetPlayerController(APlayerController* InPlayerController) { PlayerController = InPlayerController; }
@@ -498,7 +1294,7 @@ public:
 
 	/*Get the Players Pawn you are using.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
-		APawn* GetPlayerPawn() const { return PlayerPawn; }
+		APawn* GetPlayerPawn() const { return PlayerPawn.Get(); }
 	/*Specify Players Pawn for use by the component.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
 		void SetPlayerPawn(APawn* InPlayerPawn) { PlayerPawn = InPlayerPawn; }
@@ -576,12 +1372,42 @@ public:
 	/*Parameter for VInterpConstantTo, interpolation speed of the relocation vector.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
 		float GetLocationSpeed() const { return LocationSpeed; }
+	/*How TransformActor follows the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetLocationSmoothingMode(ELocationSmoothingMode InLocationSmoothingMode) { LocationSmoothingMode = InLocationSmoothingMode; }
+	/*How TransformActor follows the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		ELocationSmoothingMode GetLocationSmoothingMode() const { return LocationSmoothingMode; }
+	/*Time constant of the CriticallyDamped smoothing in seconds.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetLocationSmoothingTime(float InLocationSmoothingTime) { LocationSmoothingTime = FMath::Max(InLocationSmoothingTime, 0.001f); }
+	/*Time constant of the CriticallyDamped smoothing in seconds.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		float GetLocationSmoothingTime() const { return LocationSmoothingTime; }
+	/*The CriticallyDamped smoothing aims ahead of the cursor by its velocity multiplied by this time.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetLocationPredictionTime(float InLocationPredictionTime) { LocationPredictionTime = FMath::Max(InLocationPredictionTime, 0.f); }
+	/*The CriticallyDamped smoothing aims ahead of the cursor by its velocity multiplied by this time.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		float GetLocationPredictionTime() const { return LocationPredictionTime; }
 	/*If true than actor under cursor can't move through other objects . If false than actor can do it*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
 		void SetSweep(bool InSweep) { bSweep = InSweep; }
 	/*If true than actor under cursor can't move through other objects . If false than actor can do it*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
 		bool GetSweep() const { return bSweep; }
+	/*How the translation is swept when bSweep is true.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetSweepMode(ETransformSweepMode InSweepMode) { SweepMode = InSweepMode; }
+	/*How the translation is swept when bSweep is true.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		ETransformSweepMode GetSweepMode() const { return SweepMode; }
+	/*Time in milliseconds that the substepped sweeps may take in one update.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetSweepTimeBudgetMs(float InSweepTimeBudgetMs) { SweepTimeBudgetMs = FMath::Max(InSweepTimeBudgetMs, 0.01f); }
+	/*Time in milliseconds that the substepped sweeps may take in one update.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		float GetSweepTimeBudgetMs() const { return SweepTimeBudgetMs; }
 	/*Scaling speed.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
 		void SetScaleSpeed(float InScaleSpeed) { ScaleSpeed = InScaleSpeed; }
@@ -615,7 +1441,7 @@ public:
 	rotation with cursor,
 	translation with keyboard and rotation with keyboard.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
-		USceneComponent* GetComponentForTransformationAxis() const { return ComponentForTransformationAxis; }
+		USceneComponent* GetComponentForTransformationAxis() const { return ComponentForTransformationAxis.Get(); }
 
 
 	/*The speed of movement to the depth (from yourself or to yourself).*/
@@ -624,6 +1450,66 @@ public:
 	/*The speed of movement to the depth (from yourself or to yourself).*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
 		float GetLocationDeepSpeed() const { return LocationDeepSpeed; }
+	/*If true than the moved actor is put on the surface under the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetPlaceOnSurface(bool InPlaceOnSurface) { bPlaceOnSurface = InPlaceOnSurface; }
+	/*If true than the moved actor is put on the surface under the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		bool GetPlaceOnSurface() const { return bPlaceOnSurface; }
+	/*If true than the actor placed on the surface is turned so its up axis is the surface normal.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetAlignToSurfaceNormal(bool InAlignToSurfaceNormal) { bAlignToSurfaceNormal = InAlignToSurfaceNormal; }
+	/*If true than the actor placed on the surface is turned so its up axis is the surface normal.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		bool GetAlignToSurfaceNormal() const { return bAlignToSurfaceNormal; }
+	/*Channel of the surface traces.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetSurfaceTraceChannel(ECollisionChannel InSurfaceTraceChannel) { SurfaceTraceChannel = InSurfaceTraceChannel; }
+	/*Channel of the surface traces.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		ECollisionChannel GetSurfaceTraceChannel() const { return SurfaceTraceChannel; }
+	/*When the selected actors are dragged as the cheap proxies.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetDragProxyMode(ETransformDragProxyMode InDragProxyMode) { DragProxyMode = InDragProxyMode; }
+	/*When the selected actors are dragged as the cheap proxies.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		ETransformDragProxyMode GetDragProxyMode() const { return DragProxyMode; }
+	/*Time in milliseconds of one move of the actor above which the Auto mode drags it as a proxy.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetDragProxyCostThresholdMs(float InDragProxyCostThresholdMs) { DragProxyCostThresholdMs = FMath::Max(InDragProxyCostThresholdMs, 0.f); }
+	/*Time in milliseconds of one move of the actor above which the Auto mode drags it as a proxy.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		float GetDragProxyCostThresholdMs() const { return DragProxyCostThresholdMs; }
+	/*Estimated component cost of the actor above which the Auto mode drags it as a proxy.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetDragProxyComponentCostThreshold(int32 InDragProxyComponentCostThreshold) { DragProxyComponentCostThreshold = FMath::Max(InDragProxyComponentCostThreshold, 1); }
+	/*Estimated component cost of the actor above which the Auto mode drags it as a proxy.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		int32 GetDragProxyComponentCostThreshold() const { return DragProxyComponentCostThreshold; }
+	/*Simplified mesh of the proxy. If not set, the proxy is the box of the bounds.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetDragProxyMesh(UStaticMesh* InDragProxyMesh) { DragProxyMesh = InDragProxyMesh; }
+	/*Simplified mesh of the proxy. If not set, the proxy is the box of the bounds.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		UStaticMesh* GetDragProxyMesh() const { return DragProxyMesh; }
+	/*If true than the moves of the actors in one update are batched.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetBatchDragMovement(bool InBatchDragMovement) { bBatchDragMovement = InBatchDragMovement; }
+	/*If true than the moves of the actors in one update are batched.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		bool GetBatchDragMovement() const { return bBatchDragMovement; }
+	/*If true than the overlaps of the transformed actors are held back during the transformation. Used by the next transformation.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetDeferDragOverlaps(bool InDeferDragOverlaps) { bDeferDragOverlaps = InDeferDragOverlaps; }
+	/*If true than the overlaps of the transformed actors are held back during the transformation.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		bool GetDeferDragOverlaps() const { return bDeferDragOverlaps; }
+	/*Interval in seconds of the overlap updates during the transformation. 0 - only at the end of the transformation.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Setters")
+		void SetDragOverlapUpdateInterval(float InDragOverlapUpdateInterval) { DragOverlapUpdateInterval = FMath::Max(InDragOverlapUpdateInterval, 0.f); }
+	/*Interval in seconds of the overlap updates during the transformation. 0 - only at the end of the transformation.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Getters")
+		float GetDragOverlapUpdateInterval() const { return DragOverlapUpdateInterval; }
 
 
 	/*Minimum scale with cursor and keyboard.*/
@@ -720,6 +1606,173 @@ public:
 	/*Speed of scale actor with keyboard.*/
 	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Keyboard | Getters")
 		float GetScaleSpeedKeyboard() const { return ScaleSpeedKeyboard; }
+	/*Apply the keyboard input once per frame, scaled by the frame time.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Keyboard | Setters")
+		void SetCoalesceKeyboardInput(bool InCoalesceKeyboardInput) { bCoalesceKeyboardInput = InCoalesceKeyboardInput; }
+	/*Apply the keyboard input once per frame, scaled by the frame time.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Keyboard | Getters")
+		bool GetCoalesceKeyboardInput() const { return bCoalesceKeyboardInput; }
+
+
+	/*If true than a click on a new actor adds it to the selected actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		void SetIsAdditiveSelection(bool InIsAdditiveSelection) { bIsAdditiveSelection = InIsAdditiveSelection; }
+	/*If true than a click on a new actor adds it to the selected actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Selection")
+		bool GetIsAdditiveSelection() const { return bIsAdditiveSelection; }
+
+
+	/*Find the actor under cursor in the spatial index.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		void SetUseSpatialIndexPicking(bool InUseSpatialIndexPicking) { bUseSpatialIndexPicking = InUseSpatialIndexPicking; }
+	/*Find the actor under cursor in the spatial index.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		bool GetUseSpatialIndexPicking() const { return bUseSpatialIndexPicking; }
+	/*Reject the actor found in the spatial index if it is occluded.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		void SetTestPickingOcclusion(bool InTestPickingOcclusion) { bTestPickingOcclusion = InTestPickingOcclusion; }
+	/*Reject the actor found in the spatial index if it is occluded.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		bool GetTestPickingOcclusion() const { return bTestPickingOcclusion; }
+	/*Don't block the game thread with the trace under the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		void SetUseAsyncPicking(bool InUseAsyncPicking) { bUseAsyncPicking = InUseAsyncPicking; }
+	/*Don't block the game thread with the trace under the cursor.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		bool GetUseAsyncPicking() const { return bUseAsyncPicking; }
+	/*Transform the instances of instanced static mesh components instead of the whole actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		void SetPickInstances(bool InPickInstances) { bPickInstances = InPickInstances; }
+	/*Transform the instances of instanced static mesh components instead of the whole actors.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		bool GetPickInstances() const { return bPickInstances; }
+	/*Destroy the proxies of the instances that are not selected and not transformed.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		void ClearInstanceProxies();
+	/*The async trace under the cursor is not finished.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Picking")
+		bool GetIsCursorPickPending() const { return bIsCursorPickPending; }
+
+
+	/*Write the transformation sessions to the undo history.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		void SetIsHistoryEnabled(bool InIsHistoryEnabled) { bIsHistoryEnabled = InIsHistoryEnabled; }
+	/*Write the transformation sessions to the undo history.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		bool GetIsHistoryEnabled() const { return bIsHistoryEnabled; }
+	/*Maximum number of records in the undo history.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		void SetMaxHistoryRecords(int32 InMaxHistoryRecords);
+	/*Maximum number of records in the undo history.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		int32 GetMaxHistoryRecords() const { return MaxHistoryRecords; }
+	/*Is there an entry to undo.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		bool CanUndoTransformation() const { return History.CanUndo(); }
+	/*Is there an entry to redo.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | History")
+		bool CanRedoTransformation() const { return History.CanRedo(); }
+
+
+	/*Replicate the transformation sessions. Must be set before BeginPlay().*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Replication")
+		void SetIsReplicateTransformation(bool InIsReplicateTransformation) { bIsReplicateTransformation = InIsReplicateTransformation; }
+	/*Replicate the transformation sessions.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Replication")
+		bool GetIsReplicateTransformation() const { return bIsReplicateTransformation; }
+	/*Maximum number of the network updates per second.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Replication")
+		void SetNetUpdateRate(float InNetUpdateRate) { NetUpdateRate = FMath::Clamp(InNetUpdateRate, 1.f, 60.f); }
+	/*Maximum number of the network updates per second.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Replication")
+		float GetNetUpdateRate() const { return NetUpdateRate; }
+	/*Speed of the interpolation of the remote sessions.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Replication")
+		void SetNetInterpolationSpeed(float InNetInterpolationSpeed) { NetInterpolationSpeed = FMath::Max(InNetInterpolationSpeed, 0.f); }
+	/*Speed of the interpolation of the remote sessions.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Replication")
+		float GetNetInterpolationSpeed() const { return NetInterpolationSpeed; }
+
+
+	/*Validate the transforms of the clients on the server.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Validation")
+		void SetIsServerValidationEnabled(bool InIsServerValidationEnabled) { bIsServerValidationEnabled = InIsServerValidationEnabled; }
+	/*Validate the transforms of the clients on the server.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Validation")
+		bool GetIsServerValidationEnabled() const { return bIsServerValidationEnabled; }
+	/*Maximum distance of an actor from the location last accepted by the server. 0 - no limit.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Validation")
+		void SetValidationMaxDistance(float InValidationMaxDistance) { ValidationMaxDistance = FMath::Max(InValidationMaxDistance, 0.f); }
+	/*Maximum distance of an actor from the location last accepted by the server. 0 - no limit.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Validation")
+		float GetValidationMaxDistance() const { return ValidationMaxDistance; }
+	/*The actors must stay inside one of the volumes. Empty - no limit.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Validation")
+		void SetValidationVolumes(const TArray<AVolume*>& InValidationVolumes) { ValidationVolumes = InValidationVolumes; }
+	/*The actors must stay inside one of the volumes. Empty - no limit.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Validation")
+		TArray<AVolume*> GetValidationVolumes() const { return ValidationVolumes; }
+
+
+	/*Time in milliseconds that the restore of the snapshot may take in one frame.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		void SetSnapshotRestoreBudgetMs(float InSnapshotRestoreBudgetMs) { SnapshotRestoreBudgetMs = FMath::Max(InSnapshotRestoreBudgetMs, 0.1f); }
+	/*Time in milliseconds that the restore of the snapshot may take in one frame.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		float GetSnapshotRestoreBudgetMs() const { return SnapshotRestoreBudgetMs; }
+	/*Maximum number of the queued transform commands applied in one frame.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Commands")
+		void SetCommandsPerFrame(int32 InCommandsPerFrame) { CommandsPerFrame = FMath::Max(InCommandsPerFrame, 1); }
+	/*Maximum number of the queued transform commands applied in one frame.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Commands")
+		int32 GetCommandsPerFrame() const { return CommandsPerFrame; }
+	/*The snapshot is being restored.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapshot")
+		bool GetIsSnapshotRestoring() const { return Snapshot.IsRestoring(); }
+
+
+	/*Snap the location to the grid.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		void SetIsLocationSnapEnabled(bool InIsLocationSnapEnabled) { bIsLocationSnapEnabled = InIsLocationSnapEnabled; }
+	/*Snap the location to the grid.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		bool GetIsLocationSnapEnabled() const { return bIsLocationSnapEnabled; }
+	/*Size of the location grid.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		void SetLocationSnapGrid(float InLocationSnapGrid) { LocationSnapGrid = FMath::Max(InLocationSnapGrid, 0.01f); }
+	/*Size of the location grid.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		float GetLocationSnapGrid() const { return LocationSnapGrid; }
+	/*Snap the rotation to the angle step.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		void SetIsRotationSnapEnabled(bool InIsRotationSnapEnabled) { bIsRotationSnapEnabled = InIsRotationSnapEnabled; }
+	/*Snap the rotation to the angle step.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		bool GetIsRotationSnapEnabled() const { return bIsRotationSnapEnabled; }
+	/*Angle step in degrees.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		void SetRotationSnapStep(float InRotationSnapStep) { RotationSnapStep = FMath::Max(InRotationSnapStep, 0.01f); }
+	/*Angle step in degrees.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		float GetRotationSnapStep() const { return RotationSnapStep; }
+	/*Snap the scale to the scale step.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		void SetIsScaleSnapEnabled(bool InIsScaleSnapEnabled) { bIsScaleSnapEnabled = InIsScaleSnapEnabled; }
+	/*Snap the scale to the scale step.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		bool GetIsScaleSnapEnabled() const { return bIsScaleSnapEnabled; }
+	/*Scale step.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		void SetScaleSnapStep(float InScaleSnapStep) { ScaleSnapStep = FMath::Max(InScaleSnapStep, 0.001f); }
+	/*Scale step.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		float GetScaleSnapStep() const { return ScaleSnapStep; }
+	/*Space of the location grid and the rotation steps.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		void SetSnapSpace(ETransformationSnapSpace InSnapSpace) { SnapSpace = InSnapSpace; }
+	/*Space of the location grid and the rotation steps.*/
+	UFUNCTION(BlueprintCallable, Category = "TransformationActorsComponent | Snapping")
+		ETransformationSnapSpace GetSnapSpace() const { return SnapSpace; }
 
 
 
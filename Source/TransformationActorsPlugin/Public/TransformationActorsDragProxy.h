@@ -0,0 +1,54 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TransformationActorsDragProxy.generated.h"
+
+class UBoxComponent;
+class UStaticMesh;
+class UStaticMeshComponent;
+
+/*
+Cheap stand-in of a heavy actor during the drag.
+The proxy is a box of the bounds of the actor or a mesh fitted into them, it follows the cursor instead of the actor,
+and the component moves the actor once to the transform of the proxy when the transformation is stopped.
+The proxy does not block anything, its box only answers the bounds queries.
+*/
+UCLASS(NotPlaceable, Transient, NotBlueprintable)
+class TRANSFORMATIONACTORSPLUGIN_API ATransformationActorsDragProxy : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ATransformationActorsDragProxy();
+
+	/*Stand in for the actor: take its transform and bounds. Mesh replaces the box if it is set.*/
+	void SetActor(AActor* InActor, UStaticMesh* Mesh);
+
+	/*Hide the proxy and forget the actor. The proxy can be used again.*/
+	void Release();
+
+	AActor* GetActor() const { return Actor.Get(); }
+
+	/*
+	Estimated cost of one move of the actor, its attached actors included:
+	1 for a scene component, 2 for a primitive with the overlap events, 4 for a light, 8 for a skeletal mesh.
+	*/
+	static int32 EstimateMoveCost(const AActor* InActor);
+
+	UPROPERTY()
+		USceneComponent* Root;
+
+	UPROPERTY()
+		UBoxComponent* Box;
+
+	UPROPERTY()
+		UStaticMeshComponent* MeshComponent;
+
+private:
+
+	TWeakObjectPtr<AActor> Actor;
+};
@@ -0,0 +1,129 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+
+/*
+Undo and redo history of the transformations.
+One entry is written for one transaction: a drag session, a keyboard or batch operation over any number of actors.
+The entry keeps only the quantized differences between the transforms at the start and at the end of the transaction.
+A record is the weak pointer to the actor and the packed bytes: a flags byte and the changed parts as zigzag varints,
+the unchanged parts are not stored. A move by a few hundred units takes about 16 bytes, a full change of the transform about 33, an FTransform takes 48.
+The oldest entries are dropped when the number of records exceeds the limit.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsHistory
+{
+public:
+
+	FTransformationActorsHistory();
+
+	/*Remember the transforms of the actors at the start of the transaction.*/
+	void BeginTransaction(const TArray<AActor*>& Actors);
+
+	/*Write the changes of the actors since BeginTransaction(). Return false if there are no changes.*/
+	bool CommitTransaction();
+
+	/*Forget the transaction without writing it.*/
+	void CancelTransaction();
+
+	/*Is BeginTransaction() called without CommitTransaction().*/
+	bool IsTransactionOpen() const { return bIsTransactionOpen; }
+
+	/*Revert the last entry.*/
+	bool Undo();
+
+	/*Apply the last reverted entry again.*/
+	bool Redo();
+
+	bool CanUndo() const { return UndoEntries > 0; }
+	bool CanRedo() const { return UndoEntries < Entries.Num() - FirstEntry; }
+
+	/*Actors of the entry that the next Undo() or Redo() applies.*/
+	void GetUndoActors(TArray<AActor*>& OutActors) const;
+	void GetRedoActors(TArray<AActor*>& OutActors) const;
+
+	/*Remove all entries.*/
+	void Empty();
+
+	/*Maximum number of records (one record is the change of one actor). The oldest entries are dropped to keep the limit.*/
+	void SetMaxRecords(int32 InMaxRecords);
+	int32 GetMaxRecords() const { return MaxRecords; }
+
+	/*Memory used by the history in bytes.*/
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	/*Quantized change of the transform of one actor, unpacked. Only the parts in the flags are valid.*/
+	struct FRecord
+	{
+		/*Translation in 1/LocationPrecision units.*/
+		int32 DeltaLocation[3];
+		/*Scale in 1/ScalePrecision units.*/
+		int32 DeltaScale[3];
+		/*World space rotation. The three smallest components of the quaternion, the largest one is restored from them.*/
+		int16 DeltaRotation[3];
+		/*Index of the largest component of the quaternion in the low bits and the flags of the changed parts.*/
+		uint8 Flags;
+	};
+
+	/*One transaction.*/
+	struct FEntry
+	{
+		/*Absolute index of the first record and of its first packed byte.*/
+		int64 FirstRecord;
+		int64 FirstByte;
+		int32 NumRecords;
+	};
+
+	/*Quantize the difference between the transforms. Return false if there is no difference.*/
+	static bool EncodeRecord(const FTransform& StartTransform, const FTransform& EndTransform, FRecord& OutRecord);
+
+	/*Append the flags and the changed parts of the record to the data.*/
+	static void PackRecord(const FRecord& Record, TArray<uint8>& Data);
+
+	/*Read the record packed at Read. Return the position after it.*/
+	static const uint8* UnpackRecord(const uint8* Read, FRecord& OutRecord);
+
+	/*Apply the record to the actor forward (redo) or backward (undo).*/
+	static void ApplyRecord(AActor* Actor, const FRecord& Record, bool bIsForward);
+
+	/*Drop the entries after the undo position.*/
+	void DropRedoEntries();
+
+	/*Drop the oldest entries until the records fit into MaxRecords.*/
+	void DropOldEntries();
+
+	AActor* GetRecordActor(int64 AbsoluteIndex) const { return RecordActors[AbsoluteIndex - RecordsOffset].Get(); }
+
+	const uint8* GetRecordData(int64 AbsoluteByte) const { return RecordData.GetData() + (AbsoluteByte - DataOffset); }
+
+	/*Valid actors of the records of the entry.*/
+	void GetEntryActors(const FEntry& Entry, TArray<AActor*>& OutActors) const;
+
+	/*Actors of the records of all entries. RecordActors[0] has the absolute index RecordsOffset.*/
+	TArray<TWeakObjectPtr<AActor>> RecordActors;
+	int64 RecordsOffset;
+
+	/*Packed records of all entries in the same order. RecordData[0] has the absolute index DataOffset.*/
+	TArray<uint8> RecordData;
+	int64 DataOffset;
+
+	/*Entries. The dropped entries before FirstEntry are removed from the array from time to time.*/
+	TArray<FEntry> Entries;
+	int32 FirstEntry;
+
+	/*Number of the entries that can be reverted. The entries after them can be applied again.*/
+	int32 UndoEntries;
+
+	int32 MaxRecords;
+
+	/*The open transaction.*/
+	bool bIsTransactionOpen;
+	TArray<TWeakObjectPtr<AActor>> TransactionActors;
+	TArray<FTransform> TransactionStartTransforms;
+};
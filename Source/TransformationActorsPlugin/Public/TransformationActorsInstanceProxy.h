@@ -0,0 +1,63 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TransformationActorsInterface.h"
+#include "TransformationActorsInstanceProxy.generated.h"
+
+class UInstancedStaticMeshComponent;
+class ATransformationActorsInstanceProxy;
+
+/*Called when the proxy is moved.*/
+DECLARE_DELEGATE_OneParam(FOnInstanceProxyMoved, ATransformationActorsInstanceProxy*);
+
+/*
+Stand-in actor for one instance of an instanced static mesh component (ISM or HISM).
+The component selects and transforms the proxy like any other actor. The proxy reports its moves,
+and the component writes the transforms of the moved proxies to their instances once per frame.
+The interface events of the proxy are sent to the owner of the instanced component, once for each of its selected instances.
+*/
+UCLASS(NotPlaceable, Transient, NotBlueprintable)
+class TRANSFORMATIONACTORSPLUGIN_API ATransformationActorsInstanceProxy : public AActor, public ITransformationActorsInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	ATransformationActorsInstanceProxy();
+
+	/*Bind the proxy to the instance and move it to the world transform of the instance. Return false if the instance is not valid.*/
+	bool SetInstance(UInstancedStaticMeshComponent* InInstanceComponent, int32 InInstanceIndex);
+
+	UInstancedStaticMeshComponent* GetInstanceComponent() const { return InstanceComponent.Get(); }
+
+	/*Owner of the instanced component, nullptr if the instance is gone.*/
+	AActor* GetInstanceOwner() const;
+
+	int32 GetInstanceIndex() const { return InstanceIndex; }
+
+	/*Is the proxy bound to this instance.*/
+	bool IsInstance(const UInstancedStaticMeshComponent* InInstanceComponent, int32 InInstanceIndex) const;
+
+	/*Write the transform of the proxy to the instance. The render state is not marked dirty. Return false if the instance is not valid.*/
+	bool WriteInstanceTransform() const;
+
+	/*Called when the proxy is moved.*/
+	FOnInstanceProxyMoved OnMoved;
+
+	/*The move is reported and not written to the instance yet. Managed by the owner of OnMoved.*/
+	bool bIsWritePending;
+
+	UPROPERTY()
+		USceneComponent* Root;
+
+private:
+
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	TWeakObjectPtr<UInstancedStaticMeshComponent> InstanceComponent;
+
+	int32 InstanceIndex;
+};
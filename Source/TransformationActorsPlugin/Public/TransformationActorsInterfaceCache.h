@@ -0,0 +1,64 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UClass;
+class UObject;
+
+/*What the class knows about TransformationActorsInterface.*/
+enum class ETransformationActorsInterfaceCaps : uint8
+{
+	None					= 0,
+
+	//The class implements TransformationActorsInterface.
+	Implements				= 1 << 0,
+
+	//The class has an implementation of the interface events.
+	HighlightOn				= 1 << 1,
+	HighlightOff			= 1 << 2,
+	StartTransformation		= 1 << 3,
+	StopTransformation		= 1 << 4
+};
+ENUM_CLASS_FLAGS(ETransformationActorsInterfaceCaps)
+
+/*
+Per-class cache of TransformationActorsInterface checks.
+Instead of the reflection walk of ImplementsInterface() on each call, the capabilities of the class are found once and then taken from the map.
+The cache is cleared after garbage collection (the classes can be unloaded or recompiled only there) and after hot reload.
+Must be used only in the game thread.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsInterfaceCache
+{
+public:
+
+	/*Get the capabilities of the class.*/
+	static ETransformationActorsInterfaceCaps GetCaps(const UClass* Class);
+
+	/*Does the class of the object implement TransformationActorsInterface.*/
+	static bool Implements(const UObject* Object);
+
+	/*Does the class of the object implement the interface event, i.e. is it necessary to call it.*/
+	static bool HasEvent(const UObject* Object, ETransformationActorsInterfaceCaps Event);
+
+	/*Clear the cache.*/
+	static void Invalidate();
+
+	/*Subscribe to the events that invalidate the cache. Called by the module.*/
+	static void Startup();
+
+	/*Unsubscribe from the events and clear the cache. Called by the module.*/
+	static void Shutdown();
+
+private:
+
+	/*Find the capabilities of the class with the reflection.*/
+	static ETransformationActorsInterfaceCaps BuildCaps(const UClass* Class);
+
+	/*Capabilities of the classes.*/
+	static TMap<const UClass*, ETransformationActorsInterfaceCaps> CapsByClass;
+
+	static FDelegateHandle PostGarbageCollectHandle;
+	static FDelegateHandle HotReloadHandle;
+};
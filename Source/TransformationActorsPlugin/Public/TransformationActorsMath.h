@@ -0,0 +1,304 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+/*
+Batch math of the group transformation.
+The header does not depend on the engine: the transforms are passed as structures of arrays of floats
+and processed four at a time with SSE or NEON, or with the scalar fallback on other targets.
+Define TRANSFORMATIONACTORS_MATH_FORCE_SCALAR to build the scalar version on any target.
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(TRANSFORMATIONACTORS_MATH_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TRANSFORMATIONACTORS_MATH_SSE 1
+#include <emmintrin.h>
+#elif !defined(TRANSFORMATIONACTORS_MATH_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define TRANSFORMATIONACTORS_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifndef TRANSFORMATIONACTORS_MATH_SSE
+#define TRANSFORMATIONACTORS_MATH_SSE 0
+#endif
+#ifndef TRANSFORMATIONACTORS_MATH_NEON
+#define TRANSFORMATIONACTORS_MATH_NEON 0
+#endif
+
+namespace TransformationActorsMath
+{
+	/*Number of the lanes processed by one instruction.*/
+	const int32_t Lanes = 4;
+
+#if TRANSFORMATIONACTORS_MATH_SSE
+
+	typedef __m128 FFloat4;
+
+	inline FFloat4 Load4(const float* Source) { return _mm_loadu_ps(Source); }
+	inline void Store4(float* Destination, FFloat4 Value) { _mm_storeu_ps(Destination, Value); }
+	inline FFloat4 Splat4(float Value) { return _mm_set1_ps(Value); }
+	inline FFloat4 Add4(FFloat4 A, FFloat4 B) { return _mm_add_ps(A, B); }
+	inline FFloat4 Sub4(FFloat4 A, FFloat4 B) { return _mm_sub_ps(A, B); }
+	inline FFloat4 Mul4(FFloat4 A, FFloat4 B) { return _mm_mul_ps(A, B); }
+	/*A * B + C.*/
+	inline FFloat4 MulAdd4(FFloat4 A, FFloat4 B, FFloat4 C) { return _mm_add_ps(_mm_mul_ps(A, B), C); }
+	/*Bit N is set if lane N of A is greater than lane N of B.*/
+	inline int32_t GreaterMask4(FFloat4 A, FFloat4 B) { return _mm_movemask_ps(_mm_cmpgt_ps(A, B)); }
+
+#elif TRANSFORMATIONACTORS_MATH_NEON
+
+	typedef float32x4_t FFloat4;
+
+	inline FFloat4 Load4(const float* Source) { return vld1q_f32(Source); }
+	inline void Store4(float* Destination, FFloat4 Value) { vst1q_f32(Destination, Value); }
+	inline FFloat4 Splat4(float Value) { return vdupq_n_f32(Value); }
+	inline FFloat4 Add4(FFloat4 A, FFloat4 B) { return vaddq_f32(A, B); }
+	inline FFloat4 Sub4(FFloat4 A, FFloat4 B) { return vsubq_f32(A, B); }
+	inline FFloat4 Mul4(FFloat4 A, FFloat4 B) { return vmulq_f32(A, B); }
+	inline FFloat4 MulAdd4(FFloat4 A, FFloat4 B, FFloat4 C) { return vmlaq_f32(C, A, B); }
+	inline int32_t GreaterMask4(FFloat4 A, FFloat4 B)
+	{
+		const uint32x4_t Mask = vcgtq_f32(A, B);
+		return (vgetq_lane_u32(Mask, 0) & 1) | (vgetq_lane_u32(Mask, 1) & 2) | (vgetq_lane_u32(Mask, 2) & 4) | (vgetq_lane_u32(Mask, 3) & 8);
+	}
+
+#else
+
+	struct FFloat4
+	{
+		float V[4];
+	};
+
+	inline FFloat4 Load4(const float* Source) { FFloat4 R = { { Source[0], Source[1], Source[2], Source[3] } }; return R; }
+	inline void Store4(float* Destination, FFloat4 Value) { for (int32_t L = 0; L < 4; ++L) { Destination[L] = Value.V[L]; } }
+	inline FFloat4 Splat4(float Value) { FFloat4 R = { { Value, Value, Value, Value } }; return R; }
+	inline FFloat4 Add4(FFloat4 A, FFloat4 B) { for (int32_t L = 0; L < 4; ++L) { A.V[L] += B.V[L]; } return A; }
+	inline FFloat4 Sub4(FFloat4 A, FFloat4 B) { for (int32_t L = 0; L < 4; ++L) { A.V[L] -= B.V[L]; } return A; }
+	inline FFloat4 Mul4(FFloat4 A, FFloat4 B) { for (int32_t L = 0; L < 4; ++L) { A.V[L] *= B.V[L]; } return A; }
+	inline FFloat4 MulAdd4(FFloat4 A, FFloat4 B, FFloat4 C) { for (int32_t L = 0; L < 4; ++L) { C.V[L] += A.V[L] * B.V[L]; } return C; }
+	inline int32_t GreaterMask4(FFloat4 A, FFloat4 B)
+	{
+		int32_t Mask = 0;
+		for (int32_t L = 0; L < 4; ++L)
+		{
+			Mask |= A.V[L] > B.V[L] ? 1 << L : 0;
+		}
+		return Mask;
+	}
+
+#endif
+
+	/*Components of 3D vectors in separate arrays.*/
+	struct FVectorStreams
+	{
+		float* X;
+		float* Y;
+		float* Z;
+	};
+
+	/*Components of quaternions in separate arrays.*/
+	struct FQuatStreams
+	{
+		float* X;
+		float* Y;
+		float* Z;
+		float* W;
+	};
+
+	/*Locations, rotations and scales of a batch of transforms, laid out in one buffer.*/
+	struct FTransformStreams
+	{
+		FVectorStreams Locations;
+		FQuatStreams Rotations;
+		FVectorStreams Scales;
+
+		/*Number of the floats in one stream, the batch size rounded up to the lanes.*/
+		static size_t GetStride(int32_t Num) { return (static_cast<size_t>(Num) + Lanes - 1) / Lanes * Lanes; }
+
+		/*Number of the floats the buffer of Bind() must hold.*/
+		static size_t GetBufferSize(int32_t Num) { return GetStride(Num) * 10; }
+
+		/*Point the streams into Buffer of GetBufferSize(Num) floats.*/
+		void Bind(float* Buffer, int32_t Num)
+		{
+			const size_t Stride = GetStride(Num);
+			float* Streams[10];
+			for (size_t Index = 0; Index < 10; ++Index)
+			{
+				Streams[Index] = Buffer + Stride * Index;
+			}
+
+			Locations = { Streams[0], Streams[1], Streams[2] };
+			Rotations = { Streams[3], Streams[4], Streams[5], Streams[6] };
+			Scales = { Streams[7], Streams[8], Streams[9] };
+		}
+	};
+
+	/*Row-major rotation matrix of the unit quaternion (X, Y, Z, W).*/
+	inline void QuatToMatrix(const float Rotation[4], float OutMatrix[9])
+	{
+		const float X = Rotation[0], Y = Rotation[1], Z = Rotation[2], W = Rotation[3];
+
+		OutMatrix[0] = 1.f - 2.f * (Y * Y + Z * Z);
+		OutMatrix[1] = 2.f * (X * Y - W * Z);
+		OutMatrix[2] = 2.f * (X * Z + W * Y);
+		OutMatrix[3] = 2.f * (X * Y + W * Z);
+		OutMatrix[4] = 1.f - 2.f * (X * X + Z * Z);
+		OutMatrix[5] = 2.f * (Y * Z - W * X);
+		OutMatrix[6] = 2.f * (X * Z - W * Y);
+		OutMatrix[7] = 2.f * (Y * Z + W * X);
+		OutMatrix[8] = 1.f - 2.f * (X * X + Y * Y);
+	}
+
+	/*Translate Num locations by Delta. Used to move the group after the controlled actor.*/
+	inline void TranslateLocations(const FVectorStreams& Locations, int32_t Num, const float Delta[3])
+	{
+		const FFloat4 DX = Splat4(Delta[0]), DY = Splat4(Delta[1]), DZ = Splat4(Delta[2]);
+
+		int32_t Index = 0;
+		for (; Index + Lanes <= Num; Index += Lanes)
+		{
+			Store4(Locations.X + Index, Add4(Load4(Locations.X + Index), DX));
+			Store4(Locations.Y + Index, Add4(Load4(Locations.Y + Index), DY));
+			Store4(Locations.Z + Index, Add4(Load4(Locations.Z + Index), DZ));
+		}
+		for (; Index < Num; ++Index)
+		{
+			Locations.X[Index] += Delta[0];
+			Locations.Y[Index] += Delta[1];
+			Locations.Z[Index] += Delta[2];
+		}
+	}
+
+	/*
+	Rotate Num transforms by the unit quaternion DeltaRotation (X, Y, Z, W) around Pivot:
+	the offsets from the pivot are rotated and DeltaRotation is applied before each rotation.
+	*/
+	inline void RotateAroundPivot(const FVectorStreams& Locations, const FQuatStreams& Rotations, int32_t Num, const float DeltaRotation[4], const float Pivot[3])
+	{
+		/*The delta is the same for the whole batch, so the offsets are rotated by its matrix.*/
+		float Matrix[9];
+		QuatToMatrix(DeltaRotation, Matrix);
+
+		const FFloat4 M0 = Splat4(Matrix[0]), M1 = Splat4(Matrix[1]), M2 = Splat4(Matrix[2]);
+		const FFloat4 M3 = Splat4(Matrix[3]), M4 = Splat4(Matrix[4]), M5 = Splat4(Matrix[5]);
+		const FFloat4 M6 = Splat4(Matrix[6]), M7 = Splat4(Matrix[7]), M8 = Splat4(Matrix[8]);
+		const FFloat4 PX = Splat4(Pivot[0]), PY = Splat4(Pivot[1]), PZ = Splat4(Pivot[2]);
+		const FFloat4 AX = Splat4(DeltaRotation[0]), AY = Splat4(DeltaRotation[1]), AZ = Splat4(DeltaRotation[2]), AW = Splat4(DeltaRotation[3]);
+
+		int32_t Index = 0;
+		for (; Index + Lanes <= Num; Index += Lanes)
+		{
+			const FFloat4 OX = Sub4(Load4(Locations.X + Index), PX);
+			const FFloat4 OY = Sub4(Load4(Locations.Y + Index), PY);
+			const FFloat4 OZ = Sub4(Load4(Locations.Z + Index), PZ);
+
+			Store4(Locations.X + Index, Add4(PX, MulAdd4(M0, OX, MulAdd4(M1, OY, Mul4(M2, OZ)))));
+			Store4(Locations.Y + Index, Add4(PY, MulAdd4(M3, OX, MulAdd4(M4, OY, Mul4(M5, OZ)))));
+			Store4(Locations.Z + Index, Add4(PZ, MulAdd4(M6, OX, MulAdd4(M7, OY, Mul4(M8, OZ)))));
+
+			/*Hamilton product DeltaRotation * Rotation.*/
+			const FFloat4 BX = Load4(Rotations.X + Index);
+			const FFloat4 BY = Load4(Rotations.Y + Index);
+			const FFloat4 BZ = Load4(Rotations.Z + Index);
+			const FFloat4 BW = Load4(Rotations.W + Index);
+
+			Store4(Rotations.X + Index, Sub4(MulAdd4(AW, BX, MulAdd4(AX, BW, Mul4(AY, BZ))), Mul4(AZ, BY)));
+			Store4(Rotations.Y + Index, Sub4(MulAdd4(AW, BY, MulAdd4(AY, BW, Mul4(AZ, BX))), Mul4(AX, BZ)));
+			Store4(Rotations.Z + Index, Sub4(MulAdd4(AW, BZ, MulAdd4(AZ, BW, Mul4(AX, BY))), Mul4(AY, BX)));
+			Store4(Rotations.W + Index, Sub4(Mul4(AW, BW), MulAdd4(AX, BX, MulAdd4(AY, BY, Mul4(AZ, BZ)))));
+		}
+		for (; Index < Num; ++Index)
+		{
+			const float OX = Locations.X[Index] - Pivot[0];
+			const float OY = Locations.Y[Index] - Pivot[1];
+			const float OZ = Locations.Z[Index] - Pivot[2];
+
+			Locations.X[Index] = Pivot[0] + Matrix[0] * OX + Matrix[1] * OY + Matrix[2] * OZ;
+			Locations.Y[Index] = Pivot[1] + Matrix[3] * OX + Matrix[4] * OY + Matrix[5] * OZ;
+			Locations.Z[Index] = Pivot[2] + Matrix[6] * OX + Matrix[7] * OY + Matrix[8] * OZ;
+
+			const float BX = Rotations.X[Index], BY = Rotations.Y[Index], BZ = Rotations.Z[Index], BW = Rotations.W[Index];
+			const float QX = DeltaRotation[0], QY = DeltaRotation[1], QZ = DeltaRotation[2], QW = DeltaRotation[3];
+
+			Rotations.X[Index] = QW * BX + QX * BW + QY * BZ - QZ * BY;
+			Rotations.Y[Index] = QW * BY + QY * BW + QZ * BX - QX * BZ;
+			Rotations.Z[Index] = QW * BZ + QZ * BW + QX * BY - QY * BX;
+			Rotations.W[Index] = QW * BW - QX * BX - QY * BY - QZ * BZ;
+		}
+	}
+
+	/*
+	OutScales = Scales * Ratio for Num scales.
+	OutIsValid[Index] is 1 if all components of the new scale are greater than MinScale, otherwise the new scale must not be applied.
+	*/
+	inline void MultiplyScalesClamped(const FVectorStreams& Scales, const FVectorStreams& OutScales, int32_t Num, const float Ratio[3], float MinScale, uint8_t* OutIsValid)
+	{
+		const FFloat4 RX = Splat4(Ratio[0]), RY = Splat4(Ratio[1]), RZ = Splat4(Ratio[2]);
+		const FFloat4 Min = Splat4(MinScale);
+
+		int32_t Index = 0;
+		for (; Index + Lanes <= Num; Index += Lanes)
+		{
+			const FFloat4 SX = Mul4(Load4(Scales.X + Index), RX);
+			const FFloat4 SY = Mul4(Load4(Scales.Y + Index), RY);
+			const FFloat4 SZ = Mul4(Load4(Scales.Z + Index), RZ);
+
+			Store4(OutScales.X + Index, SX);
+			Store4(OutScales.Y + Index, SY);
+			Store4(OutScales.Z + Index, SZ);
+
+			const int32_t Mask = GreaterMask4(SX, Min) & GreaterMask4(SY, Min) & GreaterMask4(SZ, Min);
+			for (int32_t Lane = 0; Lane < Lanes; ++Lane)
+			{
+				OutIsValid[Index + Lane] = static_cast<uint8_t>((Mask >> Lane) & 1);
+			}
+		}
+		for (; Index < Num; ++Index)
+		{
+			OutScales.X[Index] = Scales.X[Index] * Ratio[0];
+			OutScales.Y[Index] = Scales.Y[Index] * Ratio[1];
+			OutScales.Z[Index] = Scales.Z[Index] * Ratio[2];
+
+			OutIsValid[Index] = OutScales.X[Index] > MinScale && OutScales.Y[Index] > MinScale && OutScales.Z[Index] > MinScale;
+		}
+	}
+
+	/*
+	OutScales = Scales + Delta for Num scales.
+	OutIsValid[Index] is 1 if all components of the new scale are greater than MinScale, otherwise the new scale must not be applied.
+	*/
+	inline void AddScalesClamped(const FVectorStreams& Scales, const FVectorStreams& OutScales, int32_t Num, const float Delta[3], float MinScale, uint8_t* OutIsValid)
+	{
+		const FFloat4 DX = Splat4(Delta[0]), DY = Splat4(Delta[1]), DZ = Splat4(Delta[2]);
+		const FFloat4 Min = Splat4(MinScale);
+
+		int32_t Index = 0;
+		for (; Index + Lanes <= Num; Index += Lanes)
+		{
+			const FFloat4 SX = Add4(Load4(Scales.X + Index), DX);
+			const FFloat4 SY = Add4(Load4(Scales.Y + Index), DY);
+			const FFloat4 SZ = Add4(Load4(Scales.Z + Index), DZ);
+
+			Store4(OutScales.X + Index, SX);
+			Store4(OutScales.Y + Index, SY);
+			Store4(OutScales.Z + Index, SZ);
+
+			const int32_t Mask = GreaterMask4(SX, Min) & GreaterMask4(SY, Min) & GreaterMask4(SZ, Min);
+			for (int32_t Lane = 0; Lane < Lanes; ++Lane)
+			{
+				OutIsValid[Index + Lane] = static_cast<uint8_t>((Mask >> Lane) & 1);
+			}
+		}
+		for (; Index < Num; ++Index)
+		{
+			OutScales.X[Index] = Scales.X[Index] + Delta[0];
+			OutScales.Y[Index] = Scales.Y[Index] + Delta[1];
+			OutScales.Z[Index] = Scales.Z[Index] + Delta[2];
+
+			OutIsValid[Index] = OutScales.X[Index] > MinScale && OutScales.Y[Index] > MinScale && OutScales.Z[Index] > MinScale;
+		}
+	}
+}
@@ -0,0 +1,71 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "Engine/EngineTypes.h"
+
+class AActor;
+class USceneComponent;
+class UPrimitiveComponent;
+class FScopedMovementUpdate;
+
+/*
+Moves of the actors in one update, batched by FScopedMovementUpdate on their root components.
+While the batch is open the moves only change the root transforms, the children, the physics bodies, the render state
+and the overlaps of each hierarchy are updated once when the batch is closed.
+Must be used in one scope of the game thread: the scopes of a component are closed in the reverse order of their opening.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsMovementBatch : private FNoncopyable
+{
+public:
+
+	FTransformationActorsMovementBatch();
+	~FTransformationActorsMovementBatch();
+
+	/*Defer the updates of the hierarchy of the actor until Close(). Each actor must be added once.*/
+	void Add(AActor* Actor);
+
+	/*Apply the deferred updates of all hierarchies.*/
+	void Close();
+
+private:
+
+	TArray<TUniquePtr<FScopedMovementUpdate>> Scopes;
+};
+
+/*
+Overlaps and physics volume updates of the actors held back across the updates of the transformation.
+Pause() remembers the overlaps of the primitives of the actors and their attached actors and ends them silently,
+so the moves don't query the overlaps and don't report leaving them.
+Resume() restores the remembered overlaps silently and updates the overlaps once,
+so only the difference between the place at Pause() and the current place is reported.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsOverlapDeferral
+{
+public:
+
+	FTransformationActorsOverlapDeferral();
+
+	void Pause(const TArray<AActor*>& Actors, float CurrentTime);
+
+	void Resume();
+
+	bool IsPaused() const { return PausedPrimitives.Num() > 0 || PausedVolumeComponents.Num() > 0; }
+
+	/*Time of the last Pause().*/
+	float GetPauseTime() const { return PauseTime; }
+
+private:
+
+	struct FPausedPrimitive
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		TArray<FOverlapInfo> Overlaps;
+	};
+
+	TArray<FPausedPrimitive> PausedPrimitives;
+	TArray<TWeakObjectPtr<USceneComponent>> PausedVolumeComponents;
+	float PauseTime;
+};
@@ -0,0 +1,145 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "UObject/WeakObjectPtr.h"
+#include "TransformationActorsNet.generated.h"
+
+class AActor;
+
+/*
+Quantized change of the controlled actor since the start of the network session.
+The whole group of the session is transformed rigidly around the controlled actor, so one delta describes all actors of the session.
+*/
+USTRUCT()
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsNetDelta
+{
+	GENERATED_BODY()
+
+	/*Translation with the precision of 0.1 unit.*/
+	UPROPERTY()
+		FVector_NetQuantize10 Location;
+
+	/*World space rotation, the axes are compressed to 16 bits.*/
+	UPROPERTY()
+		uint16 Pitch;
+	UPROPERTY()
+		uint16 Yaw;
+	UPROPERTY()
+		uint16 Roll;
+
+	/*Ratio of the scale with the precision of 0.01.*/
+	UPROPERTY()
+		FVector_NetQuantize100 ScaleRatio;
+
+	FTransformationActorsNetDelta();
+
+	/*Make the quantized delta between two transforms of the controlled actor.*/
+	static FTransformationActorsNetDelta Make(const FTransform& StartTransform, const FTransform& CurrentTransform);
+
+	FQuat GetRotation() const;
+
+	/*Return false if the delta can't be made by Make(): the values are not finite or out of the world.*/
+	bool IsValid() const;
+};
+
+/*Quantized transform of one actor. Used to correct actors that did not follow the delta of the session, for example blocked by the sweep.*/
+USTRUCT()
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsNetTransform
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		AActor* Actor;
+
+	UPROPERTY()
+		FVector_NetQuantize100 Location;
+
+	UPROPERTY()
+		uint16 Pitch;
+	UPROPERTY()
+		uint16 Yaw;
+	UPROPERTY()
+		uint16 Roll;
+
+	UPROPERTY()
+		FVector_NetQuantize100 Scale;
+
+	FTransformationActorsNetTransform();
+
+	static FTransformationActorsNetTransform Make(AActor* InActor, const FTransform& Transform);
+
+	FTransform GetTransform() const;
+
+	/*Return false if the transform can't be made by Make(): the values are not finite or out of the world.*/
+	bool IsValid() const;
+};
+
+/*
+Actors of one network session and their transforms at the start of it.
+On the server and on the remote clients the actors are transformed by the deltas received from the owner of the session.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsNetSession
+{
+public:
+
+	FTransformationActorsNetSession();
+
+	/*Remember the actors and their transforms. PivotActor is the controlled actor, the group is rotated around it.*/
+	void Begin(const TArray<AActor*>& InActors, AActor* PivotActor);
+
+	/*Forget the actors.*/
+	void End();
+
+	bool IsActive() const { return bIsActive; }
+
+	/*Transform all actors by the delta immediately.*/
+	void Apply(const FTransformationActorsNetDelta& Delta);
+
+	/*Set the delta that the actors approach in Interpolate().*/
+	void SetTarget(const FTransformationActorsNetDelta& Delta);
+
+	/*Move the actors toward the target delta. Return false if the target is reached.*/
+	bool Interpolate(float DeltaTime, float InterpolationSpeed);
+
+	/*Transform of the controlled actor at the start of the session.*/
+	const FTransform& GetPivotStartTransform() const { return PivotStartTransform; }
+
+	/*Actors of the session and their transforms at the start of it.*/
+	const TArray<TWeakObjectPtr<AActor>>& GetActors() const { return Actors; }
+	bool Contains(const AActor* Actor) const { return Actor && Actors.Contains(Actor); }
+	const TArray<FTransform>& GetStartTransforms() const { return StartTransforms; }
+
+	/*Transforms of all actors of the session by the delta, in the order of GetActors().*/
+	void PredictTransforms(const FTransformationActorsNetDelta& Delta, TArray<FTransform>& OutTransforms) const;
+
+	/*Find the actors whose transform differs from the one predicted by the delta and make the corrections for them.*/
+	void MakeCorrections(const FTransformationActorsNetDelta& Delta, TArray<FTransformationActorsNetTransform>& OutCorrections) const;
+
+	/*Set the transforms of the corrected actors.*/
+	static void ApplyCorrections(const TArray<FTransformationActorsNetTransform>& Corrections);
+
+private:
+
+	/*Transform of the actor with the index by the delta.*/
+	FTransform PredictTransform(int32 Index, const FVector& DeltaLocation, const FQuat& DeltaRotation, const FVector& ScaleRatio) const;
+
+	void ApplyDecoded(const FVector& DeltaLocation, const FQuat& DeltaRotation, const FVector& ScaleRatio);
+
+	bool bIsActive;
+
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TArray<FTransform> StartTransforms;
+	FTransform PivotStartTransform;
+
+	/*Interpolation state on the remote clients.*/
+	FVector CurrentLocation;
+	FQuat CurrentRotation;
+	FVector CurrentScaleRatio;
+	FVector TargetLocation;
+	FQuat TargetRotation;
+	FVector TargetScaleRatio;
+	bool bHasTarget;
+};
@@ -0,0 +1,125 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WorldCollision.h"
+#include "TransformationActorsSelection.h"
+#include "TransformationActorsHistory.h"
+#include "TransformationActorsSmoothing.h"
+#include "TransformationActorsSurfacePlacement.h"
+#include "TransformationActorsMovement.h"
+
+class AActor;
+class ATransformationActorsDragProxy;
+class APawn;
+class APlayerController;
+class FTransformationActorsRawMouseInput;
+class USceneComponent;
+enum class ETransformState : uint8;
+
+/*
+Transformation state of one player: the controlled actor, the selection, the cursor and the updates in progress.
+The component keeps the state of the active player in its own members and swaps it with the stored states of the other players,
+so all players share the component settings, the picking index and one component tick.
+*/
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsPlayerSession
+{
+public:
+
+	FTransformationActorsPlayerSession();
+
+	/*The session has an update that runs in the component tick.*/
+	bool IsUpdateActive() const { return bIsLocationTickActive || bIsRotationTickActive || bIsScaleTickActive || bIsKeyboardCommitPending; }
+
+	/*The objects of the player are weak, the state is dropped by the component when the player is destroyed.*/
+	TWeakObjectPtr<APlayerController> PlayerController;
+	TWeakObjectPtr<APawn> PlayerPawn;
+
+	/*The component from which the axes of transformation are taken.*/
+	TWeakObjectPtr<USceneComponent> ComponentForTransformationAxis;
+
+	ETransformState TransformState;
+	bool bIsTransform;
+
+	TWeakObjectPtr<AActor> TransformActor;
+	TWeakObjectPtr<AActor> PreviousTransformActor;
+
+	FTransformationActorsSelection Selection;
+	FTransformationActorsHistory History;
+
+	/*Updates in the component tick.*/
+	bool bIsLocationTickActive;
+	bool bIsRotationTickActive;
+	bool bIsScaleTickActive;
+	bool bIsLockFirstIterationLocationTimer;
+	bool bIsLockFirstIterationRotationTimer;
+	bool bIsLockFirstIterationScaleTimer;
+
+	/*Raw mouse input of the rotation or the scale and the cursor made of its deltas.*/
+	TSharedPtr<FTransformationActorsRawMouseInput> RawMouseInput;
+	FVector2D RawMouseCursor;
+
+	/*Cursor of the player. The virtual cursor is set by SetPlayerCursorPosition() and replaces the mouse.*/
+	bool bUseVirtualCursor;
+	FVector2D VirtualCursor;
+	/*World ray of the cursor set by SetPlayerCursorRay(). Replaces the deprojection for the remote players.*/
+	bool bUseCursorRay;
+	FVector CursorRayOrigin;
+	FVector CursorRayDirection;
+
+	/*Box selection started by BeginMarqueeSelection().*/
+	bool bIsMarqueeSelection;
+	FVector2D MarqueeStart;
+
+	/*Async trace under the cursor.*/
+	FTraceHandle CursorPickTraceHandle;
+	bool bIsCursorPickPending;
+	bool bIsStopRequestedDuringPick;
+
+	/*Keyboard input of the frame.*/
+	FVector PendingKeyboardLocation;
+	FVector PendingKeyboardRotation;
+	FVector PendingKeyboardScale3D;
+	bool bIsKeyboardCommitPending;
+
+	/*Snapping and smoothing of TransformActor.*/
+	FTransform SnapRawTransform;
+	FTransform SnapAppliedTransform;
+	TWeakObjectPtr<AActor> SnapActor;
+	FTransformationActorsLocationSpring LocationSpring;
+	float LastLocationUpdateTime;
+	FTransformationActorsSurfacePlacement SurfacePlacement;
+
+	/*Proxies dragged instead of the selected actors.*/
+	TArray<TWeakObjectPtr<ATransformationActorsDragProxy>> DragProxies;
+
+	/*Overlaps of the transformed actors held back during the transformation.*/
+	FTransformationActorsOverlapDeferral OverlapDeferral;
+
+	/*Values remembered between the updates of the cursor transformation.*/
+	float RollSave;
+	float PitchSave;
+	float YawSave;
+	float DeltaRollDegree;
+	float DeltaPitchDegree;
+	float DeltaYawDegree;
+	float DistanceToCursorSave;
+	float LocationXAtClick;
+	float LocationYAtClick;
+	FVector Scale3DSave;
+	FVector NewScale3D;
+	float SumInputAxisValue;
+
+	/*Keyboard transformation status.*/
+	bool bIsLocationLeftRightKeyboard;
+	bool bIsLocationUpDownKeyboard;
+	bool bIsLocationInsideOutsideKeyboard;
+	bool bIsRotationRollKeyboard;
+	bool bIsRotationPitchKeyboard;
+	bool bIsRotationYawKeyboard;
+	bool bIsScaleKeyboard;
+	bool bIsScaleXKeyboard;
+	bool bIsScaleYKeyboard;
+	bool bIsScaleZKeyboard;
+};
@@ -0,0 +1,47 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Application/IInputProcessor.h"
+
+/*
+Slate input preprocessor that accumulates the mouse deltas as the events arrive, before the widgets and the player input.
+The deltas are taken by the next update, so no motion between two updates is lost and the cursor position is not polled.
+The events are not consumed. Must be created with MakeShared and used only in the game thread.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsRawMouseInput : public IInputProcessor, public TSharedFromThis<FTransformationActorsRawMouseInput>
+{
+public:
+
+	/*OnFirstDelta is called when a delta arrives and there was no pending delta.*/
+	explicit FTransformationActorsRawMouseInput(TFunction<void()> InOnFirstDelta);
+
+	/*Register in the Slate application. Return false if there is no Slate application (dedicated server, commandlets).*/
+	bool Register();
+
+	/*Unregister from the Slate application.*/
+	void Unregister();
+
+	/*Is there a delta that has not been taken by ConsumeDelta().*/
+	bool HasPendingDelta() const { return bHasPendingDelta; }
+
+	/*Return the sum of the deltas since the previous call in pixels and reset it.*/
+	FVector2D ConsumeDelta();
+
+	//~ Begin IInputProcessor Interface
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	//~ End IInputProcessor Interface
+
+private:
+
+	/*Sum of the deltas that have not been taken yet.*/
+	FVector2D PendingDelta;
+
+	bool bHasPendingDelta;
+
+	bool bIsRegistered;
+
+	TFunction<void()> OnFirstDelta;
+};
@@ -0,0 +1,88 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "TransformationActorsMath.h"
+
+class AActor;
+
+/*
+Group of actors that are transformed together.
+The data of the group is stored in parallel arrays (handles and transforms at the start of the transformation),
+so one delta of the controlled actor is applied to the whole group in a single pass.
+The transforms of the pass are gathered into a structure of arrays and processed by the batch kernels of TransformationActorsMath.
+*/
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsSelection
+{
+public:
+
+	/*Add the actor to the group. Return false if the actor is not valid or is already in the group.*/
+	bool Add(AActor* Actor);
+
+	/*Remove the actor from the group. Return false if the actor is not in the group.*/
+	bool Remove(AActor* Actor);
+
+	/*Remove all actors from the group.*/
+	void Empty();
+
+	/*Is the actor in the group.*/
+	bool Contains(AActor* Actor) const { return IndexByActor.Contains(TWeakObjectPtr<AActor>(Actor)); }
+
+	/*Number of actors in the group.*/
+	int32 Num() const { return Actors.Num(); }
+
+	/*Get the actor by the index in the group. Return nullptr if the actor has been destroyed.*/
+	AActor* GetActor(int32 Index) const { return Actors[Index].Get(); }
+
+	/*Get all valid actors of the group.*/
+	void GetActors(TArray<AActor*>& OutActors) const;
+
+	/*Transform of the actor at the moment of the last CaptureTransforms() call.*/
+	const FTransform& GetStartTransform(int32 Index) const { return StartTransforms[Index]; }
+
+	/*Remember the transforms of all actors. Called at the start of the transformation.*/
+	void CaptureTransforms();
+
+	/*Translate all actors of the group, except SkipActor, by DeltaLocation.*/
+	void ApplyDeltaLocation(const FVector& DeltaLocation, bool bSweep, const AActor* SkipActor = nullptr);
+
+	/*Rotate all actors of the group, except SkipActor, by DeltaRotation around Pivot in world space.*/
+	void ApplyDeltaRotation(const FQuat& DeltaRotation, const FVector& Pivot, bool bSweep, const AActor* SkipActor = nullptr);
+
+	/*Multiply the captured scale of all actors of the group, except SkipActor, by ScaleRatio. Each actor is scaled in place.*/
+	void ApplyScaleRatio(const FVector& ScaleRatio, float MinScale, const AActor* SkipActor = nullptr);
+
+	/*Add DeltaScale3D to the current scale of all actors of the group, except SkipActor.*/
+	void ApplyDeltaScale(const FVector& DeltaScale3D, float MinScale, const AActor* SkipActor = nullptr);
+
+	/*
+	Translate all actors of the group, except SkipActor, by DeltaLocation, then rotate them by DeltaRotation around Pivot and add DeltaScale3D to their scale.
+	Each actor is moved by one SetActorTransform.
+	*/
+	void ApplyDeltaTransform(const FVector& DeltaLocation, const FQuat& DeltaRotation, const FVector& Pivot, const FVector& DeltaScale3D, float MinScale, bool bSweep, const AActor* SkipActor = nullptr);
+
+private:
+
+	/*Collect the valid actors, except SkipActor, into the batch and bind the streams to the scratch buffer. Return the size of the batch.*/
+	int32 BeginBatch(const AActor* SkipActor);
+
+	/*Handles of the actors.*/
+	TArray<TWeakObjectPtr<AActor>> Actors;
+
+	/*Transforms of the actors at the start of the transformation.*/
+	TArray<FTransform> StartTransforms;
+
+	/*Index of the actor in the arrays above.*/
+	TMap<TWeakObjectPtr<AActor>, int32> IndexByActor;
+
+	/*Actors of the current batch and their indices in the arrays above.*/
+	TArray<AActor*> BatchActors;
+	TArray<int32> BatchIndices;
+
+	/*Scratch memory of the batch kernels. Kept between the passes to avoid the allocations.*/
+	TArray<float> BatchBuffer;
+	TArray<uint8> BatchIsValid;
+	TransformationActorsMath::FTransformStreams BatchStreams;
+};
@@ -0,0 +1,58 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TransformationActorsSmoothing.generated.h"
+
+/*How TransformActor follows the cursor.*/
+UENUM(BlueprintType, Category = "TransformationActorsComponent | ELocationSmoothingMode")
+enum class ELocationSmoothingMode : uint8
+{
+	//FMath::VInterpTo with LocationSpeed and the update period.
+	ELSM_Interp				UMETA(DisplayName = "Interp"),
+
+	//Critically damped spring with LocationSmoothingTime and the measured time between the updates.
+	ELSM_CriticallyDamped	UMETA(DisplayName = "CriticallyDamped")
+};
+
+/*
+Critically damped spring that follows a moving target.
+Each update is the exact solution of the spring for the target that moves linearly between two updates,
+so the trailing behind the target does not depend on the update rate and a long frame does not overshoot.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsLocationSpring
+{
+public:
+
+	FTransformationActorsLocationSpring();
+
+	/*Put the spring at rest at Location.*/
+	void Reset(const FVector& Location);
+
+	/*
+	Move the spring toward Target during DeltaTime and return the new location.
+	SmoothingTime is the time constant of the spring. The target is led by its velocity multiplied by LeadTime,
+	LeadTime equal to SmoothingTime removes the steady lag behind the target that moves with a constant velocity.
+	*/
+	FVector Update(const FVector& Target, float DeltaTime, float SmoothingTime, float LeadTime);
+
+	/*Location of the spring after the last update.*/
+	const FVector& GetLocation() const { return Location; }
+
+private:
+
+	FVector Location;
+
+	FVector Velocity;
+
+	/*Target of the previous update with and without the lead.*/
+	FVector LastTarget;
+	FVector LastRawTarget;
+
+	/*Smoothed velocity of the target, used for the lead.*/
+	FVector TargetVelocity;
+
+	/*The spring has no target yet.*/
+	bool bIsFirstUpdate;
+};
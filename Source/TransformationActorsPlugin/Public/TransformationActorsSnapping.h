@@ -0,0 +1,97 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TransformationActorsSnapping.generated.h"
+
+/*Space of the snapping grid.*/
+UENUM(BlueprintType, Category = "TransformationActorsComponent | ETransformationSnapSpace")
+enum class ETransformationSnapSpace : uint8
+{
+	//The grid is aligned with the world axes.
+	ETSS_World			UMETA(DisplayName = "World"),
+
+	//The grid is aligned with ComponentForTransformationAxis. World if the component is not set.
+	ETSS_ComponentAxis	UMETA(DisplayName = "ComponentAxis")
+};
+
+/*
+Snapping of the controlled actor.
+Each kind of snapping is a kernel instantiated at compile time for its mode (off, world space, component space).
+Configure() selects the kernels once per update, so the snapping of one value is a call without branches on the settings.
+Only the controlled actor is snapped, the selected actors follow it with the same delta.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsSnapper
+{
+public:
+
+	FTransformationActorsSnapper();
+
+	/*Select the kernels. Space is used for the location and rotation when bIsWorldSpace is false, its scale is ignored.*/
+	void Configure(float InLocationGrid, float InRotationStep, float InScaleStep, bool bIsWorldSpace, const FTransform& InSpace);
+
+	FVector SnapLocation(const FVector& Location) const { return LocationKernel(Location, LocationGrid, Space); }
+	FQuat SnapRotation(const FQuat& Rotation) const { return RotationKernel(Rotation, RotationStep, Space); }
+	FVector SnapScale(const FVector& Scale3D) const { return ScaleKernel(Scale3D, ScaleStep); }
+
+	bool IsLocationSnapEnabled() const { return LocationGrid > 0.f; }
+	bool IsRotationSnapEnabled() const { return RotationStep > 0.f; }
+	bool IsScaleSnapEnabled() const { return ScaleStep > 0.f; }
+	bool IsSnapEnabled() const { return IsLocationSnapEnabled() || IsRotationSnapEnabled() || IsScaleSnapEnabled(); }
+
+private:
+
+	typedef FVector(*FLocationKernel)(const FVector&, float, const FTransform&);
+	typedef FQuat(*FRotationKernel)(const FQuat&, float, const FTransform&);
+	typedef FVector(*FScaleKernel)(const FVector&, float);
+
+	template <bool bIsEnabled, bool bIsWorldSpace>
+	static FVector SnapLocationKernel(const FVector& Location, float Grid, const FTransform& InSpace)
+	{
+		if (!bIsEnabled)
+		{
+			return Location;
+		}
+		if (bIsWorldSpace)
+		{
+			return Location.GridSnap(Grid);
+		}
+		return InSpace.TransformPositionNoScale(InSpace.InverseTransformPositionNoScale(Location).GridSnap(Grid));
+	}
+
+	template <bool bIsEnabled, bool bIsWorldSpace>
+	static FQuat SnapRotationKernel(const FQuat& Rotation, float Step, const FTransform& InSpace)
+	{
+		if (!bIsEnabled)
+		{
+			return Rotation;
+		}
+		if (bIsWorldSpace)
+		{
+			return Rotation.Rotator().GridSnap(FRotator(Step)).Quaternion();
+		}
+		const FQuat SpaceRotation = InSpace.GetRotation();
+		const FQuat LocalRotation = SpaceRotation.Inverse() * Rotation;
+		return SpaceRotation * LocalRotation.Rotator().GridSnap(FRotator(Step)).Quaternion();
+	}
+
+	template <bool bIsEnabled>
+	static FVector SnapScaleKernel(const FVector& Scale3D, float Step)
+	{
+		if (!bIsEnabled)
+		{
+			return Scale3D;
+		}
+		return Scale3D.GridSnap(Step);
+	}
+
+	FLocationKernel LocationKernel;
+	FRotationKernel RotationKernel;
+	FScaleKernel ScaleKernel;
+
+	float LocationGrid;
+	float RotationStep;
+	float ScaleStep;
+	FTransform Space;
+};
@@ -0,0 +1,75 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "Templates/Function.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class ULevel;
+class UWorld;
+class FArchive;
+
+/*
+Flat binary snapshot of the transforms of the actors.
+The actors are identified by the package name of their level (without the PIE prefix) and their name,
+so only the actors placed in the levels or spawned with a fixed name can be restored.
+
+Layout, version 1:
+	uint32 Magic, int32 Version,
+	int32 NumLevels, FString LevelNames[NumLevels],
+	int32 NumActors, FString ActorNames[NumActors],
+	NumActors records: int32 LevelIndex, FVector Location, FQuat Rotation, FVector Scale3D.
+The records are read from the file in batches while they are applied, the file is not loaded into memory at once.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsSnapshot
+{
+public:
+
+	static const uint32 Magic;
+	static const int32 Version;
+
+	FTransformationActorsSnapshot();
+	~FTransformationActorsSnapshot();
+
+	/*Write the transforms of the actors to the file. Return false if the file can't be written.*/
+	static bool SaveToFile(const TArray<AActor*>& Actors, const FString& FileName);
+
+	/*Open the file and read the header and the names. Return false if the file is missing or has another format.*/
+	bool BeginRestore(UWorld* World, const FString& FileName);
+
+	/*
+	Read and apply the next records until the time budget is spent. Return true when all records are applied.
+	OnBeforeRestore is called for each found actor before its transform is changed.
+	*/
+	bool RestoreBatch(double TimeBudgetSeconds, TFunctionRef<void(AActor*)> OnBeforeRestore);
+
+	/*Close the file without applying the rest of the records.*/
+	void CancelRestore();
+
+	bool IsRestoring() const { return Reader.IsValid(); }
+
+	/*Actors restored by the last restore.*/
+	const TArray<TWeakObjectPtr<AActor>>& GetRestoredActors() const { return RestoredActors; }
+
+	/*Number of the records whose actors were not found.*/
+	int32 GetNumMissingActors() const { return NumMissingActors; }
+
+private:
+
+	/*Level package name without the PIE prefix.*/
+	static FString GetLevelName(const ULevel* Level);
+
+	TUniquePtr<FArchive> Reader;
+	TWeakObjectPtr<UWorld> RestoreWorld;
+
+	TArray<TWeakObjectPtr<ULevel>> Levels;
+	TArray<FName> ActorNames;
+
+	int32 NextRecord;
+	int32 NumMissingActors;
+
+	TArray<TWeakObjectPtr<AActor>> RestoredActors;
+};
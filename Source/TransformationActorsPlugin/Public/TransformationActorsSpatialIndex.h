@@ -0,0 +1,143 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Components/SceneComponent.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class ULevel;
+class UWorld;
+struct FConvexVolume;
+
+/*
+Bounding volume hierarchy over the bounds of the actors that implement TransformationActorsInterface.
+There is one index per world, it is shared by all components of the world.
+The actors are added when the index is created, when they are spawned and when their level is added to the world.
+The bounds of the moved actors are refitted before the next query.
+Must be used only in the game thread.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsSpatialIndex
+{
+public:
+
+	/*Get the index of the world. The index is created on the first call.*/
+	static FTransformationActorsSpatialIndex* Get(UWorld* World);
+
+	/*Subscribe to the world events. Called by the module.*/
+	static void Startup();
+
+	/*Remove all indices. Called by the module.*/
+	static void Shutdown();
+
+	explicit FTransformationActorsSpatialIndex(UWorld* InWorld);
+	~FTransformationActorsSpatialIndex();
+
+	/*Add the actor to the index if it implements TransformationActorsInterface.*/
+	void AddActor(AActor* Actor);
+
+	/*Remove the actor from the index.*/
+	void RemoveActor(AActor* Actor);
+
+	/*Mark the bounds of the actor as changed.*/
+	void MarkActorDirty(AActor* Actor);
+
+	/*
+	Find the nearest actor hit by the segment from Start to End.
+	The segment is tested against the bounds in the index first, then against the simple collision of the candidates in the order of distance.
+	If bTestOcclusion is true, the hit is rejected when another object blocks the segment before the found actor.
+	*/
+	AActor* Raycast(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, bool bTestOcclusion, FHitResult& OutHit);
+
+	/*
+	Find all actors whose bounds intersect the frustum.
+	The bounds are tested in parallel chunks of the item arrays, without the hierarchy, so the cost does not depend on the shape of the frustum.
+	*/
+	void OverlapFrustum(const FConvexVolume& Frustum, TArray<AActor*>& OutActors);
+
+	/*Number of actors in the index.*/
+	int32 Num() const { return IndexByActor.Num(); }
+
+private:
+
+	/*Node of the hierarchy. The left child follows the node, the right child is stored by index.*/
+	struct FNode
+	{
+		FBox Bounds;
+		/*Items of the leaf in ItemOrder. NumItems is 0 for the inner nodes.*/
+		int32 FirstItem;
+		int32 NumItems;
+		int32 RightChild;
+		int32 Parent;
+	};
+
+	/*Candidate for the collision test.*/
+	struct FCandidate
+	{
+		int32 Item;
+		/*Distance along the segment to the bounds, 0..1.*/
+		float Time;
+	};
+
+	/*Add the actors of the level.*/
+	void AddLevelActors(ULevel* Level);
+
+	/*Recompute the bounds of the dirty items and refit the hierarchy.*/
+	void Refresh();
+
+	/*Build the hierarchy from all items.*/
+	void Rebuild();
+
+	/*Build the node for the range of ItemOrder. Return the index of the node.*/
+	int32 BuildNode(int32 FirstItem, int32 NumItems, int32 Parent);
+
+	/*Bounds of the actor used in the index.*/
+	static FBox CalcActorBounds(const AActor* Actor);
+
+	/*Test of the segment against the box. Time is the entry point, 0..1.*/
+	static bool IntersectSegmentBox(const FBox& Box, const FVector& Start, const FVector& InvDelta, float& OutTime);
+
+	void OnActorSpawned(AActor* Actor);
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	static void OnLevelAdded(ULevel* Level, UWorld* World);
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	TWeakObjectPtr<UWorld> World;
+
+	/*Items. Removed items have an invalid actor and invalid bounds until the next Rebuild().*/
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TArray<FBox> Bounds;
+	TArray<TWeakObjectPtr<USceneComponent>> RootComponents;
+	TArray<FDelegateHandle> TransformUpdatedHandles;
+	/*Leaf of the item. INDEX_NONE for the items added after the last Rebuild().*/
+	TArray<int32> LeafByItem;
+	TArray<bool> bIsDirtyByItem;
+
+	TMap<TWeakObjectPtr<AActor>, int32> IndexByActor;
+
+	/*Dirty items.*/
+	TArray<int32> DirtyItems;
+	/*Items added after the last Rebuild(). They are tested without the hierarchy.*/
+	TArray<int32> PendingItems;
+	/*Number of removed items that still take place in the arrays.*/
+	int32 NumRemovedItems;
+
+	/*The hierarchy.*/
+	TArray<FNode> Nodes;
+	TArray<int32> ItemOrder;
+
+	/*Temporary arrays of the queries.*/
+	TArray<FCandidate> Candidates;
+	TArray<int32> NodeStack;
+	TArray<bool> bIsDirtyByNode;
+	TArray<bool> bIsInFrustumByItem;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	static TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FTransformationActorsSpatialIndex>> IndexByWorld;
+	static FDelegateHandle LevelAddedHandle;
+	static FDelegateHandle WorldCleanupHandle;
+};
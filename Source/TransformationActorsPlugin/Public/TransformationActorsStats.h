@@ -0,0 +1,67 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#endif
+
+/*
+Stats of the plugin: "stat TransformationActors" in the console, the CSV profiler category TransformationActors
+and the trace scopes for Unreal Insights (named events before 4.25).
+*/
+DECLARE_STATS_GROUP(TEXT("TransformationActors"), STATGROUP_TransformationActors, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick"), STAT_TransformationActors_Tick, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update"), STAT_TransformationActors_Update, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Picking"), STAT_TransformationActors_Picking, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Deprojection"), STAT_TransformationActors_Deprojection, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Transform composition"), STAT_TransformationActors_TransformComposition, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sweep"), STAT_TransformationActors_Sweep, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Selection apply"), STAT_TransformationActors_SelectionApply, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interface dispatch"), STAT_TransformationActors_InterfaceDispatch, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spatial index query"), STAT_TransformationActors_SpatialIndexQuery, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spatial index update"), STAT_TransformationActors_SpatialIndexUpdate, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("History"), STAT_TransformationActors_History, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Net session"), STAT_TransformationActors_NetSession, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snapshot"), STAT_TransformationActors_Snapshot, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Instance update"), STAT_TransformationActors_InstanceUpdate, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validation"), STAT_TransformationActors_Validation, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Commands"), STAT_TransformationActors_Commands, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Change events"), STAT_TransformationActors_ChangeEvents, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Movement update"), STAT_TransformationActors_MovementUpdate, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+
+/*Number of the running transformation sessions.*/
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active sessions"), STAT_TransformationActors_ActiveSessions, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+/*Number of the actors moved in the frame.*/
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors moved"), STAT_TransformationActors_ActorsMoved, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+/*Number of the scene queries in the frame: the traces, the sweeps, the sweeping moves and the overlap tests.*/
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Scene queries"), STAT_TransformationActors_SceneQueries, STATGROUP_TransformationActors, TRANSFORMATIONACTORSPLUGIN_API);
+
+/*Number of the scene queries since the start, counted also without the stats. Read by the benchmark.*/
+extern TRANSFORMATIONACTORSPLUGIN_API FThreadSafeCounter GTransformationActorsSceneQueries;
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(TRANSFORMATIONACTORSPLUGIN_API, TransformationActors);
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25
+#define TRANSFORMATIONACTORS_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE(Name)
+#else
+#define TRANSFORMATIONACTORS_TRACE_SCOPE(Name) SCOPED_NAMED_EVENT(Name, FColor::Emerald)
+#endif
+
+/*Count the scene queries made by the plugin.*/
+#define TRANSFORMATIONACTORS_COUNT_QUERIES(Num) \
+	INC_DWORD_STAT_BY(STAT_TransformationActors_SceneQueries, Num); \
+	GTransformationActorsSceneQueries.Add(Num)
+
+/*Cycle stat, CSV timing and trace scope of the block. Stat is the name after STAT_TransformationActors_.*/
+#define TRANSFORMATIONACTORS_SCOPE(Stat) \
+	SCOPE_CYCLE_COUNTER(STAT_TransformationActors_##Stat); \
+	CSV_SCOPED_TIMING_STAT(TransformationActors, Stat); \
+	TRANSFORMATIONACTORS_TRACE_SCOPE(TransformationActors_##Stat)
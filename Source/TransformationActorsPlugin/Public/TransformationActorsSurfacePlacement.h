@@ -0,0 +1,67 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+
+class AActor;
+class UWorld;
+
+/*
+Placement of the controlled actor on the surface under the cursor ray.
+The ray is traced against the world asynchronously and the result is used in the next update,
+the trace is not repeated while the ray does not move, so the placement costs almost nothing when the cursor is still.
+Only the first trace of the placement is done immediately, so the actor does not jump to the ray distance before the first result.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsSurfacePlacement
+{
+public:
+
+	FTransformationActorsSurfacePlacement();
+
+	/*Start the placement of Actor. IgnoredActors (the moved actors) are not hit by the traces.*/
+	void Begin(AActor* Actor, const TArray<AActor*>& IgnoredActors, ECollisionChannel InTraceChannel);
+
+	/*Trace the ray if it has moved since the last trace and no trace is in flight. The result of the async trace comes to TraceDelegate.*/
+	void Update(UWorld* World, const FVector& RayStart, const FVector& RayEnd, FTraceDelegate* TraceDelegate);
+
+	/*Take the result of the async trace. Return false if the trace was not started by this placement.*/
+	bool OnTraceDone(const FTraceHandle& InTraceHandle, const FTraceDatum& TraceDatum);
+
+	/*A surface is found under the last traced ray.*/
+	bool HasSurface() const { return bHasSurface; }
+
+	const FVector& GetSurfaceNormal() const { return SurfaceNormal; }
+
+	/*Rotation of the actor at the start of the placement, turned so its up axis is the surface normal.*/
+	FQuat GetAlignedRotation() const;
+
+	/*Location at which the bounds of the actor with Rotation and Scale3D lie on the surface, raised by Height along the normal.*/
+	FVector GetPlacedLocation(const FQuat& Rotation, const FVector& Scale3D, float Height) const;
+
+private:
+
+	void SetHit(bool bIsHit, const FHitResult& Hit);
+
+	/*Bounds of the actor in its local space and its rotation at the start.*/
+	FBox LocalBounds;
+	FQuat StartRotation;
+
+	FCollisionQueryParams Params;
+	ECollisionChannel TraceChannel;
+
+	FTraceHandle TraceHandle;
+	bool bIsTracePending;
+
+	/*Ray of the last started trace.*/
+	FVector LastRayStart;
+	FVector LastRayEnd;
+	bool bHasRay;
+
+	/*Result of the last finished trace.*/
+	bool bHasSurface;
+	FVector SurfaceLocation;
+	FVector SurfaceNormal;
+};
@@ -0,0 +1,126 @@
+// Copyright 2020 Anatoli Kucharau. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "UObject/WeakObjectPtr.h"
+#include "TransformationActorsNet.h"
+
+class AActor;
+class AVolume;
+class UWorld;
+class UTransformationActorsComponent;
+struct FCollisionQueryParams;
+
+/*Rules that the transforms requested by a client must satisfy on the server.*/
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsPlacementRules
+{
+	FTransformationActorsPlacementRules();
+
+	/*Maximum distance of an actor from its last accepted location, i.e. the move of one request. 0 - no limit.*/
+	float MaxDistance;
+
+	/*Minimum scale on each axis.*/
+	float MinScale;
+
+	/*Test the bounds of the actors for the blocking overlaps on OverlapChannel at the new transforms.*/
+	bool bTestOverlap;
+	ECollisionChannel OverlapChannel;
+
+	/*The actors must stay inside one of the volumes. Empty - no limit.*/
+	TArray<TWeakObjectPtr<AVolume>> Volumes;
+};
+
+/*Transforms of the actors of one network session requested by the client.*/
+struct TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsValidationRequest
+{
+	FTransformationActorsValidationRequest();
+
+	/*The received delta and corrections. They are applied and relayed if the request is accepted.*/
+	FTransformationActorsNetDelta Delta;
+	TArray<FTransformationActorsNetTransform> Corrections;
+
+	/*The last request of the session, sent on stop.*/
+	bool bIsFinal;
+
+	/*Actors of the session, their transforms last accepted by the server and the requested transforms.*/
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TArray<FTransform> AcceptedTransforms;
+	TArray<FTransform> Transforms;
+
+	FTransformationActorsPlacementRules Rules;
+
+	/*Index of the next actor to test. The tests of a big request are spread over several frames.*/
+	int32 NextActor;
+};
+
+/*
+Server side queue of the transform requests of all clients of the world.
+The requests are tested against their placement rules in the order of arrival, within the limit of the tests and the time per frame,
+so the cost of the validation does not grow with the number of the editing players. A queued update of a component is replaced by its newer request.
+There is one validator per world. Must be used only in the game thread.
+*/
+class TRANSFORMATIONACTORSPLUGIN_API FTransformationActorsValidator
+{
+public:
+
+	/*Get the validator of the world. The validator is created on the first call.*/
+	static FTransformationActorsValidator* Get(UWorld* World);
+
+	/*Subscribe to the world events. Called by the module.*/
+	static void Startup();
+
+	/*Remove all validators. Called by the module.*/
+	static void Shutdown();
+
+	explicit FTransformationActorsValidator(UWorld* InWorld);
+
+	/*Queue the request of the component. An unfinished update of the component in the queue is replaced by the request.*/
+	void Submit(UTransformationActorsComponent* Component, FTransformationActorsValidationRequest&& Request);
+
+	/*Remove the requests of the component without the results.*/
+	void Cancel(const UTransformationActorsComponent* Component);
+
+	/*
+	Test the queued requests and send the results to the components, until MaxTests actors are tested or TimeBudgetSeconds is spent.
+	Runs once per frame, the next calls in the same frame do nothing.
+	*/
+	void Process(int32 MaxTests, double TimeBudgetSeconds);
+
+	/*Test all queued requests of the component now, without the limits.*/
+	void Flush(const UTransformationActorsComponent* Component);
+
+	/*Are there requests of the component in the queue.*/
+	bool IsQueued(const UTransformationActorsComponent* Component) const;
+
+	/*Number of the queued requests.*/
+	int32 Num() const { return Queue.Num(); }
+
+	/*Test the actor at the transform against the rules. The actors ignored by Params don't block the overlap.*/
+	static bool TestPlacement(UWorld* World, AActor* Actor, const FTransform& AcceptedTransform, const FTransform& Transform, const FTransformationActorsPlacementRules& Rules, const FCollisionQueryParams& Params);
+
+private:
+
+	struct FEntry
+	{
+		TWeakObjectPtr<UTransformationActorsComponent> Component;
+		FTransformationActorsValidationRequest Request;
+	};
+
+	/*Test the actors of the entry until the request is finished or MaxTests is spent. Return true and send the result if the request is finished.*/
+	bool ProcessEntry(FEntry& Entry, int32& InOutMaxTests);
+
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	TWeakObjectPtr<UWorld> World;
+
+	/*Requests in the order of arrival.*/
+	TArray<FEntry> Queue;
+
+	/*Frame of the last Process() call.*/
+	uint64 LastProcessedFrame;
+
+	static TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FTransformationActorsValidator>> ValidatorByWorld;
+	static FDelegateHandle WorldCleanupHandle;
+};